@@ -0,0 +1,164 @@
+/**
+ * @file background.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the background picture
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "background.h"
+
+#include <QFutureWatcher>
+#include <QImage>
+#include <QLabel>
+#include <QPainter>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <cstdlib>
+
+// Counted from imgs/ by translator.pro
+#ifndef CHIERU_HORIZONTAL_BACKGROUNDS
+#define CHIERU_HORIZONTAL_BACKGROUNDS 1
+#endif
+#ifndef CHIERU_VERTICAL_BACKGROUNDS
+#define CHIERU_VERTICAL_BACKGROUNDS 1
+#endif
+
+namespace {
+
+const int kPictureCounts[] = {CHIERU_HORIZONTAL_BACKGROUNDS, CHIERU_VERTICAL_BACKGROUNDS};
+const char *const kPicturePaths[] = {":/imgs/chieruh%1.png", ":/imgs/chieruv%1.png"};
+
+const qreal kOpacity = 0.2;
+
+// Scaled pictures are cached for sizes rounded up to this many pixels
+const int kBucketSize = 64;
+const int kMaxScaled = 8;
+
+// Quiet time after a resize before the picture is scaled smoothly
+const int kSmoothDelay = 150;
+
+QImage load_faded(const QString &path) {
+    QImage picture(path);
+    if (picture.isNull()) return picture;
+
+    // Fading once here spares an opacity effect on every paint
+    QImage faded(picture.size(), QImage::Format_ARGB32_Premultiplied);
+    faded.fill(Qt::transparent);
+    QPainter painter(&faded);
+    painter.setOpacity(kOpacity);
+    painter.drawImage(0, 0, picture);
+    return faded;
+}
+
+QSize bucket_of(const QSize &size) {
+    return QSize((size.width() + kBucketSize - 1) / kBucketSize * kBucketSize,
+                 (size.height() + kBucketSize - 1) / kBucketSize * kBucketSize);
+}
+
+quint64 key_of(Background::Orientation orientation, const QSize &bucket) {
+    return quint64(orientation) << 48 | quint64(bucket.width()) << 24 | quint64(bucket.height());
+}
+
+}  // namespace
+
+Background::Background(QWidget *widget)
+    : QObject(widget)
+    , m_label(new QLabel(widget))
+    , m_smooth_timer(new QTimer(this))
+    , m_loading()
+    , m_scaled(kMaxScaled)
+    , m_orientation(Horizontal) {
+    for (int i = 0; i < OrientationCount; ++i)
+        m_paths[i] = QString(kPicturePaths[i]).arg(rand() % kPictureCounts[i]);
+
+    m_label->setAttribute(Qt::WA_TransparentForMouseEvents);
+
+    m_smooth_timer->setSingleShot(true);
+    m_smooth_timer->setInterval(kSmoothDelay);
+    connect(m_smooth_timer, &QTimer::timeout, this, &Background::smooth);
+}
+
+void Background::update(Orientation orientation, const QSize &size) {
+    m_orientation = orientation;
+    m_size = size;
+    if (m_pictures[orientation].isNull()) {
+        // Keep showing the last picture until this one is ready
+        load(orientation);
+        return;
+    }
+
+    QSize bucket = bucket_of(size);
+    if (QPixmap *scaled = m_scaled.object(key_of(orientation, bucket))) {
+        m_smooth_timer->stop();
+        show(*scaled);
+        return;
+    }
+
+    show(m_pictures[orientation].scaled(bucket, Qt::KeepAspectRatioByExpanding,
+                                        Qt::FastTransformation));
+    m_smooth_timer->start();
+}
+
+void Background::load(Orientation orientation) {
+    if (m_loading[orientation]) return;
+
+    QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+    m_loading[orientation] = watcher;
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, orientation]() {
+        watcher->deleteLater();
+        m_loading[orientation] = nullptr;
+
+        // Pixmaps can only be made on the gui thread
+        m_pictures[orientation] = QPixmap::fromImage(watcher->result());
+        if (m_pictures[orientation].isNull() || orientation != m_orientation) return;
+        smooth();
+    });
+
+    QString path = m_paths[orientation];
+    watcher->setFuture(QtConcurrent::run([path]() { return load_faded(path); }));
+}
+
+void Background::show(const QPixmap &pixmap) {
+    QWidget *widget = m_label->parentWidget();
+
+    // Center it, buckets may overflow the widget both ways
+    m_label->resize(pixmap.size());
+    m_label->move((widget->width() - pixmap.width()) / 2,
+                  (widget->height() - pixmap.height()) / 2);
+    m_label->setPixmap(pixmap);
+
+    m_label->raise();
+    m_label->show();
+}
+
+void Background::smooth() {
+    const QPixmap &picture = m_pictures[m_orientation];
+    if (picture.isNull()) return;
+
+    QSize bucket = bucket_of(m_size);
+    QPixmap *scaled = new QPixmap(picture.scaled(bucket, Qt::KeepAspectRatioByExpanding,
+                                                 Qt::SmoothTransformation));
+    show(*scaled);
+    m_scaled.insert(key_of(m_orientation, bucket), scaled);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file background.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Background picture of the main widget
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QCache>
+#include <QObject>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+class QImage;
+class QLabel;
+class QTimer;
+class QWidget;
+template <typename T> class QFutureWatcher;
+
+/**
+ * @brief Shows a faded picture, picked at random, behind a widget
+ *
+ * Pictures are decoded on the global thread pool, and the one of an
+ * orientation only when it is first shown. Scaled pictures are cached by
+ * size, rounded up to buckets. While the widget is being resized the picture
+ * is scaled fast, and smoothly once the size settles.
+ */
+class Background : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Orientation {
+        Horizontal,
+        Vertical,
+        OrientationCount
+    };
+
+    explicit Background(QWidget *widget);
+
+    /**
+     * @brief Show the picture of the orientation, covering size
+     */
+    void update(Orientation orientation, const QSize &size);
+
+private:
+    void load(Orientation orientation);
+    void show(const QPixmap &pixmap);
+    void smooth();
+
+    QLabel *m_label;
+    QTimer *m_smooth_timer;
+
+    QString m_paths[OrientationCount];
+    QPixmap m_pictures[OrientationCount];
+    QFutureWatcher<QImage> *m_loading[OrientationCount];
+    QCache<quint64, QPixmap> m_scaled;
+
+    Orientation m_orientation;
+    QSize m_size;
+};
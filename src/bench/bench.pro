@@ -0,0 +1,36 @@
+# Benchmarks of the translator core, not part of the application
+#
+# Build and run:
+#   qmake bench.pro && make && ./chieru_bench --json > results.jsonl
+#
+# Check the fast paths against the reference translator before turning them on:
+#   ./chieru_bench --verify --cases 1000000
+
+QT       += core concurrent
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = chieru_bench
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    chieru_bench.cpp \
+    chieru_verify.cpp \
+    ../chieru_async.cpp \
+    ../chieru_reference.cpp \
+    ../chieru_translator.cpp \
+    ../chieru_word_cache.cpp \
+    ../codec_layout.cpp
+
+HEADERS += \
+    chieru_verify.h \
+    ../chieru_async.h \
+    ../chieru_reference.h \
+    ../chieru_translator.h \
+    ../chieru_word_cache.h \
+    ../codec_layout.h
+
+include(../chieru_core.pri)
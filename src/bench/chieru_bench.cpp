@@ -0,0 +1,639 @@
+/**
+ * @file chieru_bench.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Benchmarks of the translator on generated corpora
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_async.h"
+#include "chieru_kernels.h"
+#include "chieru_translator.h"
+#include "chieru_verify.h"
+#include "chieru_word_cache.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <utility>
+
+// Every allocation of every thread, counted by the allocator hooks below
+static std::atomic<long long> s_allocations{0};
+
+#if defined(__GLIBC__)
+// Qt allocates with malloc, so that is where to count. Operator new ends up
+// here as well.
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+
+void* malloc(std::size_t size) noexcept {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+}
+#else
+// Elsewhere only operator new can be hooked portably, so allocations of Qt
+// containers are missed
+void* operator new(std::size_t size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+#endif
+
+namespace {
+
+/**
+ * @brief Reaches the protected pieces of the translator
+ */
+class TranslatorProbe : public ChieruTranslator {
+ public:
+    using ChieruTranslator::chieru2word;
+    using ChieruTranslator::is_separator;
+    using ChieruTranslator::word2chieru;
+};
+
+// Word of the text as [first, second) indices
+using Span = std::pair<int, int>;
+
+struct Corpus {
+    QString name;
+    QString text;       // Input of toChieru
+    QString chieru;     // Input of fromChieru
+    QByteArray utf8;
+    QByteArray chieru_utf8;
+    int words;
+};
+
+// Appends one word and what follows it to the text
+using TokenGenerator = void (*)(std::mt19937& rng, QString& text);
+
+int uniform(std::mt19937& rng, int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(rng);
+}
+
+void append_ascii_word(std::mt19937& rng, QString& text, int length) {
+    static const char kLetters[] =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    for (int i = 0; i < length; ++i) text.push_back(QChar(kLetters[uniform(rng, 0, 61)]));
+}
+
+void append_cjk_word(std::mt19937& rng, QString& text, int length) {
+    for (int i = 0; i < length; ++i) text.push_back(QChar(uniform(rng, 0x4E00, 0x9FA5)));
+}
+
+void append_symbol(std::mt19937& rng, QString& text) {
+    static const char16_t kPunctuation[] = u" ,.!?;:()[]\"'-，。！？、；：“”《》（）…～";
+    text.push_back(QChar(kPunctuation[uniform(rng, 0, sizeof(kPunctuation) / 2 - 2)]));
+}
+
+void ascii_token(std::mt19937& rng, QString& text) {
+    append_ascii_word(rng, text, uniform(rng, 1, 10));
+    if (uniform(rng, 0, 7)) text.push_back(QChar(' '));
+    else append_symbol(rng, text);
+}
+
+void cjk_token(std::mt19937& rng, QString& text) {
+    append_cjk_word(rng, text, uniform(rng, 1, 6));
+    text.push_back(QChar(uniform(rng, 0, 3) ? u'，' : u'。'));
+}
+
+void chat_token(std::mt19937& rng, QString& text) {
+    switch (uniform(rng, 0, 5)) {
+    case 0:
+    case 1:
+        append_ascii_word(rng, text, uniform(rng, 1, 8));
+        break;
+    case 2:
+    case 3:
+    case 4:
+        append_cjk_word(rng, text, uniform(rng, 1, 8));
+        break;
+    default: {
+        // An emoji, taking a surrogate pair
+        char32_t emoji = static_cast<char32_t>(uniform(rng, 0x1F600, 0x1F64F));
+        text.push_back(QChar::highSurrogate(emoji));
+        text.push_back(QChar::lowSurrogate(emoji));
+        break;
+    }
+    }
+    if (uniform(rng, 0, 2)) text.push_back(QChar(' '));
+    else append_symbol(rng, text);
+}
+
+void punctuation_token(std::mt19937& rng, QString& text) {
+    append_ascii_word(rng, text, uniform(rng, 1, 2));
+    for (int i = uniform(rng, 1, 4); i > 0; --i) append_symbol(rng, text);
+}
+
+void long_word_token(std::mt19937& rng, QString& text) {
+    append_ascii_word(rng, text, 64);
+}
+
+void invalid_token(std::mt19937& rng, QString& text) {
+    // Words of a wrong length, with strangers among the glyphs, or missing '切'
+    if (uniform(rng, 0, 3)) text.push_back(QChar(chieru::kGlyphs[0]));
+    for (int i = uniform(rng, 1, 12); i > 0; --i) {
+        if (uniform(rng, 0, 5)) text.push_back(QChar(chieru::kGlyphs[uniform(rng, 0, 15)]));
+        else append_cjk_word(rng, text, 1);
+    }
+    text.push_back(QChar(' '));
+}
+
+struct CorpusKind {
+    const char* name;
+    TokenGenerator token;
+    bool is_chieru;   // The text is (broken) Chieru already
+};
+
+const CorpusKind kCorpusKinds[] = {
+    {"ascii", ascii_token, false},
+    {"cjk", cjk_token, false},
+    {"chat", chat_token, false},
+    {"punctuation", punctuation_token, false},
+    {"long_word", long_word_token, false},
+    {"invalid", invalid_token, true},
+};
+
+int count_words(const QString& text) {
+    int words = 0;
+    bool in_word = false;
+    for (QChar ch : text) {
+        bool separator = TranslatorProbe::is_separator(ch);
+        if (!separator && !in_word) ++words;
+        in_word = !separator;
+    }
+    return words;
+}
+
+// Words of text after the index from
+QVector<Span> word_spans(const QString& text, int from) {
+    QVector<Span> spans;
+    int begin = -1;
+    for (int i = from; i <= text.length(); ++i) {
+        bool separator = i == text.length() || TranslatorProbe::is_separator(text[i]);
+        if (separator && begin >= 0) {
+            spans.push_back(Span(begin, i));
+            begin = -1;
+        } else if (!separator && begin < 0) {
+            begin = i;
+        }
+    }
+    return spans;
+}
+
+QVector<Span> word_spans(const QByteArray& utf8) {
+    QVector<Span> spans;
+    const char* begin = utf8.constData();
+    const char* end = begin + utf8.size();
+    for (const char* word = begin; word != end;) {
+        const char* separator = chieru::find_separator_utf8(word, end);
+        if (separator != word)
+            spans.push_back(Span(static_cast<int>(word - begin), static_cast<int>(separator - begin)));
+        if (separator == end) break;
+        word = separator + chieru::utf8_separator_length(separator, end);
+    }
+    return spans;
+}
+
+/**
+ * @brief Generate about size bytes (in utf-8) of the kind of text, the same
+ *          text for the same size every run
+ */
+Corpus make_corpus(const CorpusKind& kind, qint64 size, ChieruTranslator& translator) {
+    std::mt19937 rng(static_cast<unsigned>(size));
+    QString text;
+    qint64 bytes = 0;
+    while (bytes < size) {
+        int old_length = text.length();
+        kind.token(rng, text);
+        bytes += static_cast<qint64>(chieru::utf8_length(
+            reinterpret_cast<const char16_t*>(text.constData() + old_length),
+            static_cast<std::size_t>(text.length() - old_length)));
+    }
+
+    Corpus corpus;
+    corpus.name = QString::fromLatin1(kind.name);
+    corpus.text = text;
+    corpus.chieru = kind.is_chieru ? QString::fromUtf16(u"切噜～♪") + text
+                                   : translator.toChieru(text);
+    corpus.utf8 = corpus.text.toUtf8();
+    corpus.chieru_utf8 = corpus.chieru.toUtf8();
+    corpus.words = count_words(text);
+    return corpus;
+}
+
+struct Measurement {
+    double seconds;         // Of one pass over the corpus
+    double allocations;     // Per pass
+    long long passes;
+};
+
+// Results are summed into here, so that no work is optimized away
+volatile qint64 s_sink = 0;
+
+/**
+ * @brief Run pass until min_seconds are spent, after one pass to warm up
+ */
+template <typename Pass>
+Measurement measure(Pass pass, double min_seconds) {
+    using Clock = std::chrono::steady_clock;
+
+    s_sink = s_sink + pass();
+
+    long long allocations = s_allocations.load();
+    long long passes = 0;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0;
+    do {
+        s_sink = s_sink + pass();
+        ++passes;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < min_seconds);
+
+    Measurement measurement;
+    measurement.seconds = elapsed / passes;
+    measurement.allocations = static_cast<double>(s_allocations.load() - allocations) / passes;
+    measurement.passes = passes;
+    return measurement;
+}
+
+struct Options {
+    QStringList benches;
+    QStringList corpora;
+    QVector<qint64> sizes;
+    double min_seconds;
+    bool json;
+    QTextCodec* codec;
+};
+
+const char* const kBenches[] = {
+    "word2chieru", "chieru2word", "is_separator", "toChieru", "fromChieru",
+    "toChieruUtf8", "fromChieruUtf8", "validateChieruUtf8",
+    "fromChieruFragmentsUtf8", "asyncToChieru", "asyncFromChieru"
+};
+
+// Per-word benchmarks keep a span for every word, which gets heavy for huge
+// corpora, so they stop at this size
+const qint64 kMaxWordBenchSize = 64 << 20;
+
+/**
+ * @brief Run one benchmark on one corpus
+ *
+ * @param bytes Set to the utf-8 size of the input
+ * @param calls Set to the count of calls to the benchmarked function per pass
+ * @return bool Whether the benchmark applies to the corpus size
+ */
+bool run_bench(const QString& bench, const Corpus& corpus, const Options& options,
+               ChieruTranslator& translator, Measurement& measurement,
+               qint64& bytes, qint64& calls) {
+    bool per_word = bench == "word2chieru" || bench == "chieru2word";
+    if (per_word && corpus.utf8.size() > kMaxWordBenchSize) return false;
+
+    calls = 1;
+    if (bench == "word2chieru") {
+        QVector<Span> spans = word_spans(corpus.utf8);
+        const QByteArray& utf8 = corpus.utf8;
+        bytes = utf8.size();
+        calls = spans.size();
+        measurement = measure([&]() {
+            qint64 sum = 0;
+            for (const Span& span : spans)
+                sum += TranslatorProbe::word2chieru(utf8.begin() + span.first,
+                                                    utf8.begin() + span.second).size();
+            return sum;
+        }, options.min_seconds);
+    } else if (bench == "chieru2word") {
+        // Past the "切噜～♪" header
+        QVector<Span> spans = word_spans(corpus.chieru, 4);
+        const QString& chieru = corpus.chieru;
+        bytes = corpus.chieru_utf8.size();
+        calls = spans.size();
+        measurement = measure([&]() {
+            qint64 sum = 0;
+            for (const Span& span : spans)
+                sum += TranslatorProbe::chieru2word(chieru.begin() + span.first,
+                                                    chieru.begin() + span.second).size();
+            return sum;
+        }, options.min_seconds);
+    } else if (bench == "is_separator") {
+        const QString& text = corpus.text;
+        bytes = corpus.utf8.size();
+        calls = text.length();
+        measurement = measure([&]() {
+            qint64 sum = 0;
+            for (QChar ch : text) sum += TranslatorProbe::is_separator(ch);
+            return sum;
+        }, options.min_seconds);
+    } else if (bench == "toChieru") {
+        bytes = corpus.utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(translator.toChieru(corpus.text, options.codec).size());
+        }, options.min_seconds);
+    } else if (bench == "fromChieru") {
+        bytes = corpus.chieru_utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(translator.fromChieru(corpus.chieru, options.codec).size());
+        }, options.min_seconds);
+    } else if (bench == "toChieruUtf8") {
+        std::string_view utf8(corpus.utf8.constData(), static_cast<std::size_t>(corpus.utf8.size()));
+        std::string out(ChieruTranslator::toChieruUtf8Bound(utf8.size()), '\0');
+        bytes = corpus.utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(ChieruTranslator::toChieruUtf8(utf8, &out[0]));
+        }, options.min_seconds);
+    } else if (bench == "fromChieruUtf8") {
+        std::string_view chieru(corpus.chieru_utf8.constData(),
+                                static_cast<std::size_t>(corpus.chieru_utf8.size()));
+        std::string out(ChieruTranslator::fromChieruUtf8Bound(chieru.size()), '\0');
+        bytes = corpus.chieru_utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(ChieruTranslator::fromChieruUtf8(chieru, &out[0]));
+        }, options.min_seconds);
+    } else if (bench == "validateChieruUtf8") {
+        std::string_view chieru(corpus.chieru_utf8.constData(),
+                                static_cast<std::size_t>(corpus.chieru_utf8.size()));
+        bytes = corpus.chieru_utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(ChieruTranslator::validateChieruUtf8(chieru).offset);
+        }, options.min_seconds);
+    } else if (bench == "fromChieruFragmentsUtf8") {
+        // Ordinary text, which the scanner has to pass through
+        std::string_view utf8(corpus.utf8.constData(), static_cast<std::size_t>(corpus.utf8.size()));
+        std::string out(utf8.size(), '\0');
+        bytes = corpus.utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(ChieruTranslator::fromChieruFragmentsUtf8(utf8, &out[0]));
+        }, options.min_seconds);
+    } else if (bench == "asyncToChieru") {
+        // Next to toChieru, shows whether the pieces still use every core
+        ChieruAsyncTranslator async(&translator);
+        bytes = corpus.utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(async.toChieru(corpus.text, options.codec).result().size());
+        }, options.min_seconds);
+    } else if (bench == "asyncFromChieru") {
+        ChieruAsyncTranslator async(&translator);
+        bytes = corpus.chieru_utf8.size();
+        measurement = measure([&]() {
+            return static_cast<qint64>(
+                async.fromChieru(corpus.chieru, options.codec).result().size());
+        }, options.min_seconds);
+    }
+    return true;
+}
+
+const char* isa_name(chieru::KernelIsa isa) {
+    switch (isa) {
+    case chieru::KernelIsa::AVX2:
+        return "avx2";
+    case chieru::KernelIsa::SSE41:
+        return "sse4.1";
+    default:
+        return "scalar";
+    }
+}
+
+// Parse sizes like "16", "4K" or "256M"
+bool parse_size(const QString& text, qint64& size) {
+    qint64 unit = 1;
+    QString digits = text.trimmed().toUpper();
+    if (digits.endsWith('K')) unit = qint64(1) << 10;
+    else if (digits.endsWith('M')) unit = qint64(1) << 20;
+    else if (digits.endsWith('G')) unit = qint64(1) << 30;
+    if (unit != 1) digits.chop(1);
+
+    bool ok = false;
+    size = digits.toLongLong(&ok) * unit;
+    return ok && size > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("chieru_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Benchmarks the Chieru translator on generated corpora.\n"
+        "With --verify, checks it against the reference translator instead.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"bench", "Comma separated benchmarks to run, all by default.", "names"},
+        {"corpus", "Comma separated corpora: ascii, cjk, chat, punctuation, long_word, invalid.",
+         "names"},
+        {"sizes", "Comma separated corpus sizes in utf-8 bytes, K/M/G suffixes allowed.", "sizes",
+         "16,1K,64K,1M,16M"},
+        {"min-time", "Seconds to spend on every measurement.", "seconds", "0.2"},
+        {"isa", "Force the kernels to scalar, sse4.1 or avx2.", "isa"},
+        {"codec", "Codec of toChieru and fromChieru, utf-8 by default.", "name"},
+        {"parallel-threshold", "Parallel threshold of the translator, 0 to stay on one core.",
+         "length"},
+        {"word-cache", "Give the translator a word cache of <bytes>, K/M/G suffixes allowed.",
+         "bytes"},
+        {"json", "Print one JSON object per line instead of a table."},
+        {"verify", "Instead of benchmarking, check every fast path against the reference "
+                   "translator on generated inputs."},
+        {"cases", "With --verify, count of generated cases.", "count", "100000"},
+        {"seed", "With --verify, seed of the generator.", "seed", "1"},
+        {"codecs", "With --verify, comma separated codecs to check.", "names",
+         "UTF-8,GBK,GB18030,Big5,Shift_JIS,EUC-JP,EUC-KR,ISO-2022-JP,ISO-8859-1"},
+    });
+    parser.process(app);
+
+    if (parser.isSet("verify")) {
+        VerifyOptions verify;
+        verify.cases = parser.value("cases").toULongLong();
+        verify.seed = parser.value("seed").toUInt();
+        verify.max_reports = 20;
+        for (const QString& name : parser.value("codecs").split(',')) {
+            QTextCodec* codec = QTextCodec::codecForName(name.toLatin1());
+            if (codec)
+                verify.codecs.push_back(codec);
+            else
+                std::fprintf(stderr, "Skipping unknown codec: %s\n", qPrintable(name));
+        }
+        return run_verify(verify) ? 0 : 1;
+    }
+
+    Options options;
+    for (const char* bench : kBenches) options.benches << QString::fromLatin1(bench);
+    for (const CorpusKind& kind : kCorpusKinds) options.corpora << QString::fromLatin1(kind.name);
+    if (parser.isSet("bench")) options.benches = parser.value("bench").split(',');
+    if (parser.isSet("corpus")) options.corpora = parser.value("corpus").split(',');
+    for (const QString& text : parser.value("sizes").split(',')) {
+        qint64 size;
+        if (!parse_size(text, size)) {
+            std::fprintf(stderr, "Bad size: %s\n", qPrintable(text));
+            return 1;
+        }
+        options.sizes.push_back(size);
+    }
+    for (const QString& bench : options.benches) {
+        bool known = false;
+        for (const char* name : kBenches) known |= bench == QLatin1String(name);
+        if (!known) {
+            std::fprintf(stderr, "Unknown bench: %s\n", qPrintable(bench));
+            return 1;
+        }
+    }
+    options.min_seconds = parser.value("min-time").toDouble();
+    options.json = parser.isSet("json");
+    options.codec = nullptr;
+    if (parser.isSet("codec")) {
+        options.codec = QTextCodec::codecForName(parser.value("codec").toLatin1());
+        if (!options.codec) {
+            std::fprintf(stderr, "Unknown codec: %s\n", qPrintable(parser.value("codec")));
+            return 1;
+        }
+    }
+
+    if (parser.isSet("isa")) {
+        QString isa = parser.value("isa");
+        if (isa == "scalar") chieru::set_kernel_isa(chieru::KernelIsa::Scalar);
+        else if (isa == "sse4.1") chieru::set_kernel_isa(chieru::KernelIsa::SSE41);
+        else if (isa == "avx2") chieru::set_kernel_isa(chieru::KernelIsa::AVX2);
+        else {
+            std::fprintf(stderr, "Unknown isa: %s\n", qPrintable(isa));
+            return 1;
+        }
+    }
+
+    ChieruTranslator translator;
+    if (parser.isSet("parallel-threshold"))
+        translator.setParallelThreshold(parser.value("parallel-threshold").toInt());
+
+    std::unique_ptr<ChieruWordCache> cache;
+    if (parser.isSet("word-cache")) {
+        qint64 bytes;
+        if (!parse_size(parser.value("word-cache"), bytes)) {
+            std::fprintf(stderr, "Bad size: %s\n", qPrintable(parser.value("word-cache")));
+            return 1;
+        }
+        cache.reset(new ChieruWordCache(static_cast<std::size_t>(bytes)));
+        translator.setWordCache(cache.get());
+    }
+
+    QByteArray codec = options.codec ? options.codec->name() : QByteArray("UTF-8");
+    const char* codec_name = codec.constData();
+    if (options.json) {
+        std::printf("{\"isa\":\"%s\",\"threads\":%d,\"codec\":\"%s\",\"parallel_threshold\":%d,"
+                    "\"qt\":\"%s\"}\n",
+                    isa_name(chieru::kernel_isa()), QThread::idealThreadCount(), codec_name,
+                    translator.parallelThreshold(), qVersion());
+    } else {
+        std::printf("isa %s, %d threads, codec %s, parallel threshold %d, Qt %s\n\n",
+                    isa_name(chieru::kernel_isa()), QThread::idealThreadCount(), codec_name,
+                    translator.parallelThreshold(), qVersion());
+        std::printf("%-16s %-12s %12s %10s %10s %10s %12s\n", "bench", "corpus", "bytes",
+                    "words", "MB/s", "ns/word", "allocs/call");
+    }
+
+    for (const QString& corpus_name : options.corpora) {
+        const CorpusKind* kind = nullptr;
+        for (const CorpusKind& candidate : kCorpusKinds)
+            if (corpus_name == QLatin1String(candidate.name)) kind = &candidate;
+        if (!kind) {
+            std::fprintf(stderr, "Unknown corpus: %s\n", qPrintable(corpus_name));
+            return 1;
+        }
+
+        for (qint64 size : options.sizes) {
+            Corpus corpus = make_corpus(*kind, size, translator);
+
+            for (const QString& bench : options.benches) {
+                Measurement measurement;
+                qint64 bytes = 0;
+                qint64 calls = 0;
+                if (!run_bench(bench, corpus, options, translator, measurement, bytes, calls))
+                    continue;
+
+                double mb_per_s = bytes / measurement.seconds / 1e6;
+                double ns_per_word = corpus.words ? measurement.seconds * 1e9 / corpus.words : 0;
+                double allocs_per_call = calls ? measurement.allocations / calls : 0;
+                if (options.json) {
+                    std::printf("{\"bench\":\"%s\",\"corpus\":\"%s\",\"size\":%lld,\"bytes\":%lld,"
+                                "\"words\":%d,\"passes\":%lld,\"seconds_per_pass\":%.9g,"
+                                "\"mb_per_s\":%.6g,\"ns_per_word\":%.6g,\"allocs_per_call\":%.6g}\n",
+                                qPrintable(bench), kind->name, static_cast<long long>(size),
+                                static_cast<long long>(bytes), corpus.words, measurement.passes,
+                                measurement.seconds, mb_per_s, ns_per_word, allocs_per_call);
+                } else {
+                    std::printf("%-16s %-12s %12lld %10d %10.1f %10.2f %12.3f\n",
+                                qPrintable(bench), kind->name, static_cast<long long>(bytes),
+                                corpus.words, mb_per_s, ns_per_word, allocs_per_call);
+                }
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    if (cache) {
+        ChieruWordCache::Stats stats = cache->stats();
+        if (options.json)
+            std::printf("{\"word_cache\":{\"hits\":%llu,\"misses\":%llu,\"evictions\":%llu,"
+                        "\"entries\":%llu,\"bytes\":%llu}}\n",
+                        static_cast<unsigned long long>(stats.hits),
+                        static_cast<unsigned long long>(stats.misses),
+                        static_cast<unsigned long long>(stats.evictions),
+                        static_cast<unsigned long long>(stats.entries),
+                        static_cast<unsigned long long>(stats.bytes));
+        else
+            std::printf("\nword cache: %llu hits, %llu misses, %llu evictions, %llu entries in %llu bytes\n",
+                        static_cast<unsigned long long>(stats.hits),
+                        static_cast<unsigned long long>(stats.misses),
+                        static_cast<unsigned long long>(stats.evictions),
+                        static_cast<unsigned long long>(stats.entries),
+                        static_cast<unsigned long long>(stats.bytes));
+    }
+    return 0;
+}
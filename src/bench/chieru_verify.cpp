@@ -0,0 +1,446 @@
+/**
+ * @file chieru_verify.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the differential check
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_verify.h"
+#include "chieru_kernels.h"
+#include "chieru_reference.h"
+#include "chieru_stream.h"
+#include "chieru_translator.h"
+#include "chieru_utf8.h"
+#include "chieru_word_cache.h"
+#include "codec_layout.h"
+
+#include <QTextCodec>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Reaches the protected pieces of the translator
+ */
+class TranslatorProbe : public ChieruTranslator {
+ public:
+    using ChieruTranslator::chieru2word;
+    using ChieruTranslator::is_separator;
+    using ChieruTranslator::word2chieru;
+};
+
+const chieru::KernelIsa kIsas[] = {
+    chieru::KernelIsa::Scalar, chieru::KernelIsa::SSE41, chieru::KernelIsa::AVX2
+};
+const char* const kIsaNames[] = {"scalar", "sse4.1", "avx2"};
+
+// Every this many cases, the text is long enough to be cut into pieces and to
+// run through whole vector blocks
+const quint64 kLongCaseInterval = 64;
+
+int uniform(std::mt19937& rng, int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(rng);
+}
+
+QByteArray random_bytes(std::mt19937& rng, int length) {
+    QByteArray bytes(length, Qt::Uninitialized);
+    for (int i = 0; i < length; ++i) bytes[i] = static_cast<char>(uniform(rng, 0, 255));
+    return bytes;
+}
+
+/**
+ * @brief Appends a charactor of any kind the translator treats differently:
+ *          ascii of every sort, Chinese symbols, glyphs, CJK, latin-1, other
+ *          BMP code units, surrogate pairs and, if allowed, lone surrogates
+ */
+void append_charactor(std::mt19937& rng, QString& text, bool lone_surrogates) {
+    static const int kSymbolCount = sizeof(chieru::kSymbols) / sizeof(char16_t) - 1;
+    switch (uniform(rng, 0, 15)) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+        text.push_back(QChar(uniform(rng, 'a', 'z')));
+        break;
+    case 4:
+        text.push_back(QChar(uniform(rng, 0, 0x7F)));
+        break;
+    case 5:
+        text.push_back(QChar(' '));
+        break;
+    case 6:
+        text.push_back(QChar(chieru::kSymbols[uniform(rng, 0, kSymbolCount - 1)]));
+        break;
+    case 7:
+    case 8:
+        text.push_back(QChar(chieru::kGlyphs[uniform(rng, 0, 15)]));
+        break;
+    case 9:
+    case 10:
+        text.push_back(QChar(uniform(rng, 0x4E00, 0x9FA5)));
+        break;
+    case 11:
+        text.push_back(QChar(uniform(rng, 0x80, 0xFF)));
+        break;
+    case 12: {
+        // Neighbours of the symbols share their pages and lead bytes
+        int ch = chieru::kSymbols[uniform(rng, 0, kSymbolCount - 1)] + uniform(rng, -2, 2);
+        text.push_back(QChar(ch));
+        break;
+    }
+    case 13: {
+        int ch = uniform(rng, 0x100, 0xFFFD);
+        if (QChar::isSurrogate(static_cast<uint>(ch))) ch = 0x3000;
+        text.push_back(QChar(ch));
+        break;
+    }
+    case 14: {
+        char32_t ch = static_cast<char32_t>(uniform(rng, 0x10000, 0x10FFFF));
+        text.push_back(QChar::highSurrogate(ch));
+        text.push_back(QChar::lowSurrogate(ch));
+        break;
+    }
+    default:
+        if (lone_surrogates) text.push_back(QChar(uniform(rng, 0xD800, 0xDFFF)));
+        else text.push_back(QChar('0' + uniform(rng, 0, 9)));
+        break;
+    }
+}
+
+QString random_text(std::mt19937& rng, int length, bool lone_surrogates) {
+    QString text;
+    while (text.length() < length) append_charactor(rng, text, lone_surrogates);
+    return text;
+}
+
+/**
+ * @brief Chieru as it would be sent, mostly with the header, valid words mixed
+ *          with ones that are cut short, too long, misspelled or headless
+ */
+QString random_chieru(std::mt19937& rng, int words) {
+    QString text;
+    if (uniform(rng, 0, 15)) text = ChieruTranslator::chieruHeader();
+
+    for (int i = 0; i < words; ++i) {
+        QString word = ChieruReference::word2chieru(random_bytes(rng, uniform(rng, 0, 12)));
+        switch (uniform(rng, 0, 7)) {
+        case 0:
+            word.chop(1);
+            break;
+        case 1:
+            word.push_back(QChar(chieru::kGlyphs[uniform(rng, 0, 15)]));
+            break;
+        case 2:
+            word[uniform(rng, 0, word.length() - 1)] = QChar(uniform(rng, 0x4E00, 0x9FA5));
+            break;
+        case 3:
+            word.remove(0, 1);
+            break;
+        default:
+            break;
+        }
+        text.append(word);
+        append_charactor(rng, text, false);
+    }
+    return text;
+}
+
+std::string to_std(const QByteArray& bytes) {
+    return std::string(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+}
+
+std::string to_utf8(const QString& text) {
+    return to_std(text.toUtf8());
+}
+
+/**
+ * @brief Translate through the stream translator, pushed in random chunks
+ */
+std::string stream(std::mt19937& rng, const std::string& input,
+                   ChieruStreamTranslator::Direction direction) {
+    ChieruStreamTranslator translator(direction);
+    std::size_t position = 0;
+    while (position < input.size()) {
+        std::size_t length = std::min<std::size_t>(input.size() - position,
+                                                   static_cast<std::size_t>(uniform(rng, 1, 97)));
+        translator.push(input.data() + position, length);
+        position += length;
+    }
+    translator.finish();
+    return translator.output();
+}
+
+class Verifier {
+ public:
+    explicit Verifier(const VerifyOptions& options) : m_options(options) {}
+
+    void check(bool ok, const char* what, const QString& input) {
+        ++m_checks;
+        if (ok) return;
+        if (++m_failures > static_cast<quint64>(m_options.max_reports)) return;
+
+        std::printf("mismatch in %s, case %llu, isa %s, codec %s: \"", what,
+                    static_cast<unsigned long long>(m_case), m_isa, m_codec);
+        for (QChar ch : input) {
+            if (ch.unicode() >= 0x20 && ch.unicode() < 0x7F && ch != '\\' && ch != '"')
+                std::printf("%c", ch.toLatin1());
+            else
+                std::printf("\\u%04X", ch.unicode());
+        }
+        std::printf("\"\n");
+    }
+
+    void check(bool ok, const char* what, const std::string& input) {
+        check(ok, what, QString::fromLatin1(input.data(), static_cast<int>(input.size())));
+    }
+
+    void setCase(quint64 index) { m_case = index; }
+    void setIsa(const char* isa) { m_isa = isa; }
+    void setCodec(const char* codec) { m_codec = codec; }
+
+    quint64 checks() const { return m_checks; }
+    quint64 failures() const { return m_failures; }
+
+ private:
+    const VerifyOptions& m_options;
+    quint64 m_checks = 0;
+    quint64 m_failures = 0;
+    quint64 m_case = 0;
+    const char* m_isa = "";
+    const char* m_codec = "";
+};
+
+/**
+ * @brief Every code unit against the reference, once per instruction set
+ */
+void verify_separators(Verifier& verifier) {
+    std::vector<char16_t> units(0x10000);
+    for (int i = 0; i < 0x10000; ++i) units[i] = static_cast<char16_t>(i);
+
+    for (int i = 0; i < 0x10000; ++i) {
+        QChar ch(i);
+        bool expected = ChieruReference::is_separator(ch);
+        verifier.check(chieru::is_separator(ch.unicode()) == expected &&
+                       TranslatorProbe::is_separator(ch) == expected, "is_separator", QString(ch));
+    }
+
+    // Several starts, so that separators land in every lane of a vector
+    const char16_t* end = units.data() + units.size();
+    for (const char16_t* begin = units.data(); begin < units.data() + 32; ++begin) {
+        for (const char16_t* word = begin; word < end; ) {
+            const char16_t* found = chieru::find_separator(word, end);
+            const char16_t* expected = word;
+            while (expected < end && !ChieruReference::is_separator(QChar(*expected))) ++expected;
+            verifier.check(found == expected, "find_separator",
+                           QString(QChar(expected < end ? *expected : 0)));
+            word = expected + 1;
+        }
+    }
+}
+
+/**
+ * @brief One word of random bytes and one broken word
+ */
+void verify_words(Verifier& verifier, std::mt19937& rng) {
+    QByteArray bytes = random_bytes(rng, uniform(rng, 0, 70));
+    QString chieru = ChieruReference::word2chieru(bytes);
+    verifier.check(TranslatorProbe::word2chieru(bytes) == chieru, "word2chieru",
+                   QString::fromLatin1(bytes.toHex()));
+    verifier.check(TranslatorProbe::chieru2word(chieru) == ChieruReference::chieru2word(chieru),
+                   "chieru2word", chieru);
+
+    QString broken = random_chieru(rng, 1);
+    if (ChieruTranslator::isChieru(broken)) broken.remove(0, 4);
+    while (!broken.isEmpty() && ChieruReference::is_separator(broken.back())) broken.chop(1);
+    QByteArray expected = ChieruReference::chieru2word(broken);
+    verifier.check(TranslatorProbe::chieru2word(broken) == expected, "chieru2word", broken);
+
+    QByteArray decoded(broken.length(), Qt::Uninitialized);
+    chieru::DecodeStatus status = ChieruTranslator::decodeWord(
+        broken.constData(), broken.constData() + broken.length(), decoded.data());
+    // A valid word may decode to "{ERROR}" as well
+    bool matches = status ? decoded.left(static_cast<int>(status.length)) == expected
+                          : expected == "{ERROR}";
+    verifier.check(matches, "decodeWord", broken);
+}
+
+struct Translators {
+    ChieruTranslator plain;         // One piece
+    ChieruTranslator parallel;      // Cut into pieces on the thread pool
+    ChieruTranslator cached;        // Words through a small cache that keeps evicting
+    ChieruWordCache cache;
+
+    Translators() : cache(64 * 1024) {
+        plain.setParallelThreshold(0);
+        parallel.setParallelThreshold(1);
+        cached.setParallelThreshold(0);
+        cached.setWordCache(&cache);
+    }
+};
+
+/**
+ * @brief A text and a Chieru text through every translator and codec
+ */
+void verify_texts(Verifier& verifier, std::mt19937& rng, const VerifyOptions& options,
+                  bool long_case, Translators& translators) {
+    int length = long_case ? uniform(rng, 4096, 40000) : uniform(rng, 0, 200);
+    QString text = random_text(rng, length, true);
+    QString chieru = random_chieru(rng, long_case ? length / 8 : uniform(rng, 0, 24));
+
+    for (QTextCodec* codec : options.codecs) {
+        QByteArray name = codec->name();
+        verifier.setCodec(name.constData());
+
+        QString expected = ChieruReference::toChieru(text, codec);
+        QString expected_back = ChieruReference::fromChieru(chieru, codec);
+        for (ChieruTranslator* translator :
+             {&translators.plain, &translators.parallel, &translators.cached}) {
+            // Pieces are only worth the thread pool for longer texts
+            if (translator == &translators.parallel && text.length() < 64) continue;
+
+            verifier.check(translator->toChieru(text, codec) == expected, "toChieru", text);
+            verifier.check(translator->fromChieru(chieru, codec) == expected_back, "fromChieru",
+                           chieru);
+        }
+
+        // Whatever went in comes back out in bytes of the codec. Stateful codecs
+        // convert word by word differently from the whole text, so they are left out.
+        if (codec->mibEnum() == 106 || CodecLayout(codec).isSupported()) {
+            QByteArray bytes = codec->fromUnicode(text);
+            verifier.check(ChieruReference::fromChieruBytes(expected, codec) == bytes,
+                           "round trip of toChieru", text);
+        }
+    }
+    verifier.setCodec("");
+}
+
+/**
+ * @brief The utf-8 translators, whole and streamed, against the reference
+ */
+void verify_utf8(Verifier& verifier, std::mt19937& rng, bool long_case) {
+    QTextCodec* utf8 = QTextCodec::codecForMib(106);
+    int length = long_case ? uniform(rng, 4096, 40000) : uniform(rng, 0, 200);
+    QString text = random_text(rng, length, false);
+    QString chieru = random_chieru(rng, long_case ? length / 8 : uniform(rng, 0, 24));
+    std::string text_utf8 = to_utf8(text);
+    std::string chieru_utf8 = to_utf8(chieru);
+
+    std::string expected = to_utf8(ChieruReference::toChieru(text, utf8));
+    std::string translated = ChieruTranslator::toChieruUtf8(text_utf8);
+    verifier.check(translated == expected, "toChieruUtf8", text);
+    verifier.check(stream(rng, text_utf8, ChieruStreamTranslator::ToChieru) == expected,
+                   "stream to Chieru", text);
+    verifier.check(ChieruTranslator::fromChieruUtf8(translated) == text_utf8,
+                   "round trip of toChieruUtf8", text);
+
+    std::string expected_back = ChieruReference::isChieru(chieru)
+        ? to_std(ChieruReference::fromChieruBytes(chieru, utf8))
+        : to_utf8(ChieruReference::fromChieru(chieru, utf8));
+    verifier.check(ChieruTranslator::fromChieruUtf8(chieru_utf8) == expected_back,
+                   "fromChieruUtf8", chieru);
+    verifier.check(stream(rng, chieru_utf8, ChieruStreamTranslator::FromChieru) == expected_back,
+                   "stream from Chieru", chieru);
+
+    // The strict decoder agrees with validation, and with the lenient one when
+    // there is nothing wrong
+    std::string strict(chieru_utf8.size(), '\0');
+    chieru::DecodeStatus status = ChieruTranslator::fromChieruUtf8Strict(chieru_utf8, &strict[0]);
+    chieru::DecodeStatus validated = ChieruTranslator::validateChieruUtf8(chieru_utf8);
+    verifier.check(status.error == validated.error && status.offset == validated.offset,
+                   "validateChieruUtf8", chieru);
+    if (status) {
+        strict.resize(status.length);
+        verifier.check(strict == expected_back, "fromChieruUtf8Strict", chieru);
+    }
+
+    // Any bytes at all, even broken utf-8, come back through Chieru
+    std::string bytes = to_std(random_bytes(rng, uniform(rng, 0, 64)));
+    verifier.check(ChieruTranslator::fromChieruUtf8(ChieruTranslator::toChieruUtf8(bytes)) == bytes,
+                   "round trip of bytes", bytes);
+}
+
+}  // namespace
+
+bool run_verify(const VerifyOptions& options) {
+    Verifier verifier(options);
+    std::mt19937 rng(options.seed);
+    Translators translators;
+
+    // Instruction sets the cpu lacks fall back to another, only check each once
+    chieru::KernelIsa original = chieru::kernel_isa();
+    QVector<int> isas;
+    for (int i = 0; i < 3; ++i) {
+        chieru::set_kernel_isa(kIsas[i]);
+        if (chieru::kernel_isa() == kIsas[i]) isas.push_back(i);
+    }
+
+    std::printf("verifying %llu cases with seed %u on", static_cast<unsigned long long>(options.cases),
+                options.seed);
+    for (int isa : isas) std::printf(" %s", kIsaNames[isa]);
+    std::printf(", codecs");
+    for (QTextCodec* codec : options.codecs) std::printf(" %s", codec->name().constData());
+    std::printf("\n");
+    std::fflush(stdout);
+
+    for (int isa : isas) {
+        chieru::set_kernel_isa(kIsas[isa]);
+        verifier.setIsa(kIsaNames[isa]);
+        verify_separators(verifier);
+    }
+
+    quint64 report_interval = std::max<quint64>(options.cases / 10, 1);
+    for (quint64 index = 0; index < options.cases; ++index) {
+        verifier.setCase(index);
+        bool long_case = index % kLongCaseInterval == kLongCaseInterval - 1;
+
+        // The same inputs for every instruction set
+        std::mt19937 case_rng(rng());
+        for (int isa : isas) {
+            std::mt19937 isa_rng = case_rng;
+            chieru::set_kernel_isa(kIsas[isa]);
+            verifier.setIsa(kIsaNames[isa]);
+            verify_words(verifier, isa_rng);
+            verify_texts(verifier, isa_rng, options, long_case, translators);
+            verify_utf8(verifier, isa_rng, long_case);
+        }
+
+        if ((index + 1) % report_interval == 0) {
+            std::printf("%llu cases, %llu checks, %llu mismatches\n",
+                        static_cast<unsigned long long>(index + 1),
+                        static_cast<unsigned long long>(verifier.checks()),
+                        static_cast<unsigned long long>(verifier.failures()));
+            std::fflush(stdout);
+        }
+    }
+
+    chieru::set_kernel_isa(original);
+    return verifier.failures() == 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file chieru_verify.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Differential check of every fast path against the reference translator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QList>
+
+class QTextCodec;
+
+struct VerifyOptions {
+    quint64 cases;
+    quint32 seed;
+    QList<QTextCodec*> codecs;
+    int max_reports;    // Mismatches printed before the rest are only counted
+};
+
+/**
+ * @brief Translate generated inputs with every instruction set, parallel and
+ *          cached translation, the utf-8 paths and the stream translator at
+ *          random chunk sizes, comparing each with ChieruReference and
+ *          checking that translations round trip
+ *
+ * @return bool Whether everything matched
+ */
+bool run_verify(const VerifyOptions& options);
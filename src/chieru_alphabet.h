@@ -0,0 +1,141 @@
+/**
+ * @file chieru_alphabet.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Compile-time tables of 16-glyph alphabets
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chieru {
+
+/**
+ * @brief Slot of a code unit in a 32-entry table under a hash multiplier
+ */
+constexpr unsigned glyph_hash(char16_t unit, uint16_t multiplier) {
+    return static_cast<uint16_t>(unit * multiplier) >> 11;
+}
+
+/**
+ * @brief Find the smallest multiplier that hashes 16 glyphs into distinct
+ *          slots, 0 if there is none
+ */
+constexpr uint16_t find_hash_multiplier(const char16_t (&glyphs)[16]) {
+    for (unsigned multiplier = 1; multiplier <= 0xFFFF; ++multiplier) {
+        uint32_t used = 0;
+        bool perfect = true;
+        for (int i = 0; i < 16 && perfect; ++i) {
+            uint32_t slot = uint32_t(1) << glyph_hash(glyphs[i], static_cast<uint16_t>(multiplier));
+            perfect = !(used & slot);
+            used |= slot;
+        }
+        if (perfect) return static_cast<uint16_t>(multiplier);
+    }
+    return 0;
+}
+
+/**
+ * @brief Nibble of the glyph in every hash slot, 0x80 for the slots no glyph
+ *          hashes to
+ */
+struct GlyphHashTable {
+    alignas(16) uint8_t nibble[32];
+
+    constexpr GlyphHashTable(const char16_t (&glyphs)[16], uint16_t multiplier) : nibble() {
+        for (int i = 0; i < 32; ++i) nibble[i] = 0x80;
+        for (int i = 0; i < 16; ++i) nibble[glyph_hash(glyphs[i], multiplier)] = static_cast<uint8_t>(i);
+    }
+};
+
+/**
+ * @brief Forward and reverse tables of a 16-glyph alphabet, all built at
+ *          compile time
+ *
+ * @tparam Dialect A type with `static constexpr char16_t kGlyphs[16]`, the glyph
+ *          standing for every nibble
+ *
+ * Decoding finds the candidate nibble of any code unit with one lookup in a
+ * perfect hash, then checks that the glyph of that nibble is the unit.
+ */
+template <typename Dialect>
+struct Alphabet {
+    static constexpr uint16_t kHashMultiplier = find_hash_multiplier(Dialect::kGlyphs);
+    static_assert(kHashMultiplier != 0, "no perfect hash for the glyphs of the dialect");
+
+    static constexpr GlyphHashTable kHashTable{Dialect::kGlyphs, kHashMultiplier};
+
+    static constexpr char16_t glyph(unsigned nibble) {
+        return Dialect::kGlyphs[nibble];
+    }
+
+    static constexpr unsigned hash(char16_t unit) {
+        return glyph_hash(unit, kHashMultiplier);
+    }
+
+    /**
+     * @brief The nibble of the unit, or a negative number if it isn't a glyph
+     */
+    static constexpr int nibble(char16_t unit) {
+        uint8_t nibble = kHashTable.nibble[hash(unit)];
+        if (nibble & 0x80 || glyph(nibble) != unit) return -1;
+        return nibble;
+    }
+
+    /**
+     * @brief Encode bytes into glyphs, low nibble first
+     *
+     * @param dst Output, must have room for 2 * length code units
+     */
+    static constexpr void encode(const unsigned char* src, std::size_t length, char16_t* dst) {
+        for (const unsigned char* end = src + length; src != end; ++src) {
+            *dst++ = glyph(*src & 15);
+            *dst++ = glyph(*src >> 4);
+        }
+    }
+
+    /**
+     * @brief Decode glyphs back into bytes, two glyphs per byte
+     *
+     * @param length Count of code units in src, must be even
+     * @return std::size_t Index of the first code unit that isn't a glyph, or
+     *          length when every unit is valid
+     */
+    static constexpr std::size_t decode(const char16_t* src, std::size_t length,
+                                        unsigned char* dst) {
+        for (std::size_t i = 0; i < length; i += 2) {
+            int low = nibble(src[i]);
+            if (low < 0) return i;
+            int high = nibble(src[i + 1]);
+            if (high < 0) return i + 1;
+            *dst++ = static_cast<unsigned char>(low | high << 4);
+        }
+        return length;
+    }
+};
+
+}  // namespace chieru
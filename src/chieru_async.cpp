@@ -0,0 +1,221 @@
+/**
+ * @file chieru_async.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of asynchronous translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_async.h"
+#include "chieru_kernels.h"
+#include "chieru_translator.h"
+
+#include <QFutureInterface>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QTextCodec>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+
+namespace {
+
+/**
+ * @brief What a translation is asked for, to find the same request in flight
+ */
+struct Request {
+    int direction;
+    QTextCodec* codec;
+    uint hash;      // Of the text, computed once
+    QString text;
+
+    bool operator==(const Request& other) const {
+        return direction == other.direction && codec == other.codec && hash == other.hash &&
+               text == other.text;
+    }
+};
+
+uint qHash(const Request& request, uint seed = 0) {
+    return request.hash ^ static_cast<uint>(request.direction) ^ seed;
+}
+
+/**
+ * @brief Translations not finished yet, of every async translator
+ */
+struct InFlight {
+    QMutex mutex;
+    QHash<Request, QFutureInterface<QString>> requests;
+};
+
+InFlight* in_flight() {
+    // Left to the end of the process, like the executor its work runs on
+    static InFlight* in_flight = new InFlight;
+    return in_flight;
+}
+
+/**
+ * @brief Lengths of the pieces [from, to) of the text is cut into
+ */
+QVector<int> cut(const QString& text, int from, int to, int piece_length) {
+    QVector<int> lengths;
+    const char16_t* data = reinterpret_cast<const char16_t*>(text.constData());
+    chieru::cut_pieces(data + from, data + to, static_cast<std::size_t>(piece_length),
+                       [&lengths](std::size_t length) {
+        lengths.push_back(static_cast<int>(length));
+    });
+    return lengths;
+}
+
+/**
+ * @brief Translate piece by piece, reporting progress and giving up once the
+ *          future is cancelled
+ *
+ * @return bool Whether the translation was finished
+ */
+bool translate(ChieruTranslator* translator, bool to_chieru, const QString& text,
+               QTextCodec* codec, QFutureInterface<QString>& interface, QString& result) {
+    interface.setProgressRange(0, text.length());
+
+    // Pieces below the parallel threshold would each run on one core
+    int piece_length = qMax(ChieruAsyncTranslator::kPieceLength, translator->parallelThreshold());
+
+    // Texts of one piece go through in one call, on every core if long enough
+    if (text.length() <= piece_length ||
+        (!to_chieru && !ChieruTranslator::isChieru(text))) {
+        result = to_chieru ? translator->toChieru(text, codec) : translator->fromChieru(text, codec);
+        interface.setProgressValue(text.length());
+        return true;
+    }
+
+    if (to_chieru) {
+        result = ChieruTranslator::chieruHeader();
+        result.reserve(text.length() * 2);
+        int position = 0;
+        for (int length : cut(text, 0, text.length(), piece_length)) {
+            if (interface.isCanceled()) return false;
+            result.append(translator->toChieruBody(text.mid(position, length), codec));
+            position += length;
+            interface.setProgressValue(position);
+        }
+        return true;
+    }
+
+    // Bytes of a charactor may be split between pieces, which the decoder
+    // keeps until the rest arrives
+    if (!codec) codec = QTextCodec::codecForName("UTF-8");
+    QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+
+    int position = ChieruTranslator::chieruHeader().length();
+    for (int length : cut(text, position, text.length(), piece_length)) {
+        if (interface.isCanceled()) return false;
+        result.append(decoder->toUnicode(translator->fromChieruBody(text.mid(position, length),
+                                                                    codec)));
+        position += length;
+        interface.setProgressValue(position);
+    }
+    return true;
+}
+
+}  // namespace
+
+/**
+ * @brief What the async translator shares with the translations it started
+ */
+struct ChieruAsyncTranslator::State {
+    ChieruTranslator* translator;
+    QScopedPointer<ChieruTranslator> owned;
+};
+
+ChieruAsyncTranslator::ChieruAsyncTranslator(ChieruTranslator* translator)
+    : m_state(new State) {
+    if (!translator) {
+        m_state->owned.reset(new ChieruTranslator);
+        translator = m_state->owned.data();
+    }
+    m_state->translator = translator;
+}
+
+ChieruAsyncTranslator::~ChieruAsyncTranslator() {}
+
+QThreadPool* ChieruAsyncTranslator::executor() {
+    // Apart from the global pool, which the translator cuts large texts onto
+    static QThreadPool* pool = []() {
+        QThreadPool* pool = new QThreadPool;
+        pool->setMaxThreadCount(QThread::idealThreadCount());
+        return pool;
+    }();
+    return pool;
+}
+
+void ChieruAsyncTranslator::setMaxConcurrency(int threads) {
+    executor()->setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+}
+
+int ChieruAsyncTranslator::maxConcurrency() {
+    return executor()->maxThreadCount();
+}
+
+QFuture<QString> ChieruAsyncTranslator::toChieru(const QString& string, QTextCodec* codec) {
+    return start(ToChieru, string, codec);
+}
+
+QFuture<QString> ChieruAsyncTranslator::fromChieru(const QString& string, QTextCodec* codec) {
+    return start(FromChieru, string, codec);
+}
+
+QFuture<QString> ChieruAsyncTranslator::start(Direction direction, const QString& string,
+                                              QTextCodec* codec) {
+    Request request{direction, codec, qHash(string), string};
+    QFutureInterface<QString> interface;
+    InFlight* shared = in_flight();
+    {
+        QMutexLocker locker(&shared->mutex);
+        auto found = shared->requests.find(request);
+        if (found != shared->requests.end() && !found->isCanceled())
+            return found->future();
+
+        interface.reportStarted();
+        shared->requests.insert(request, interface);
+    }
+
+    QSharedPointer<State> state = m_state;
+    QtConcurrent::run(executor(), [state, shared, request, interface]() mutable {
+        QString result;
+        if (!interface.isCanceled() &&
+            translate(state->translator, request.direction == ToChieru, request.text,
+                      request.codec, interface, result))
+            interface.reportResult(result);
+
+        {
+            // A cancelled request may have been replaced by a new one already
+            QMutexLocker locker(&shared->mutex);
+            auto found = shared->requests.find(request);
+            if (found != shared->requests.end() && *found == interface)
+                shared->requests.erase(found);
+        }
+        interface.reportFinished();
+    });
+    return interface.future();
+}
@@ -0,0 +1,129 @@
+/**
+ * @file chieru_async.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Asynchronous translation on a shared, bounded thread pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QString>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define CHIERU_HAS_COROUTINES 1
+#endif
+
+class ChieruTranslator;
+class QTextCodec;
+class QThreadPool;
+
+/**
+ * @brief Translates in the background and hands out QFutures, so that event
+ *          driven callers never block on a large text
+ *
+ * Texts are translated on one thread pool shared by every async translator,
+ * at most maxConcurrency() at a time, piece by piece:
+ * - cancelling a future stops its translation at the next piece;
+ * - progress, in charactors of the text, is reported through the future, see
+ *   QFutureWatcher::progressValueChanged();
+ * - a request for the same text, direction and codec as one still in flight,
+ *   from any async translator, gets the future of that one instead of
+ *   translating it again. Cancelling it cancels it for all of them. The
+ *   settings of a translator don't change its results, so they don't matter.
+ *
+ * The translator must outlive the translations, like in TranslationTask.
+ */
+class ChieruAsyncTranslator {
+ public:
+    // Texts are cut at the first separator after every this many charactors,
+    // or after the parallel threshold of the translator if that is larger, so
+    // that every piece is still translated on every core
+    static const int kPieceLength = 1 << 20;
+
+    /**
+     * @param translator Does the translation, a default one if nullptr
+     */
+    explicit ChieruAsyncTranslator(ChieruTranslator* translator = nullptr);
+    ~ChieruAsyncTranslator();
+
+    QFuture<QString> toChieru(const QString& string, QTextCodec* codec = nullptr);
+    QFuture<QString> fromChieru(const QString& string, QTextCodec* codec = nullptr);
+
+    /**
+     * @brief The pool every async translator runs on, one thread per core by
+     *          default
+     */
+    static QThreadPool* executor();
+    static void setMaxConcurrency(int threads);
+    static int maxConcurrency();
+
+    struct State;
+
+ private:
+    enum Direction {
+        ToChieru,
+        FromChieru
+    };
+
+    QFuture<QString> start(Direction direction, const QString& string, QTextCodec* codec);
+
+    QSharedPointer<State> m_state;
+};
+
+#ifdef CHIERU_HAS_COROUTINES
+
+/**
+ * @brief Awaits a QFuture in a C++20 coroutine, resuming it from the event
+ *          loop of the thread that awaited, with a default value if cancelled
+ *
+ *     QString chieru = co_await ChieruFutureAwaiter(async.toChieru(text));
+ */
+template <typename Type>
+class ChieruFutureAwaiter {
+ public:
+    explicit ChieruFutureAwaiter(QFuture<Type> future) : m_future(future) {}
+
+    bool await_ready() const { return m_future.isFinished(); }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto* watcher = new QFutureWatcher<Type>();
+        QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handle]() {
+            watcher->deleteLater();
+            handle.resume();
+        });
+        watcher->setFuture(m_future);
+    }
+
+    Type await_resume() const {
+        return m_future.isCanceled() || m_future.resultCount() == 0 ? Type() : m_future.result();
+    }
+
+ private:
+    QFuture<Type> m_future;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file chieru_batch.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of batch translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_batch.h"
+#include "chieru_utf8.h"
+
+#include <algorithm>
+#include <cstring>
+
+template <typename Bound, typename Translate>
+void ChieruBatch::translate(const std::string_view* messages, std::size_t count,
+                            Bound bound_of, Translate translate_one) {
+    m_results.clear();
+    m_results.reserve(count);
+
+    // Room for the worst case of one message at a time, so that only what is
+    // written gets touched
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        reserve(offset, offset + bound_of(messages[i].size()));
+        std::size_t length = translate_one(messages[i], m_arena.get() + offset);
+        m_results.push_back(Result{offset, length});
+        offset += length;
+    }
+}
+
+void ChieruBatch::reserve(std::size_t used, std::size_t size) {
+    if (size <= m_capacity) return;
+
+    // Doubling keeps a batch growing message by message linear in its size
+    std::size_t capacity = std::max(size, m_capacity * 2);
+    std::unique_ptr<char[]> arena(new char[capacity]);  // Left uninitialized
+    if (used) std::memcpy(arena.get(), m_arena.get(), used);
+    m_arena = std::move(arena);
+    m_capacity = capacity;
+}
+
+void ChieruBatch::toChieru(const std::string_view* messages, std::size_t count) {
+    translate(messages, count, chieru::to_chieru_utf8_bound, chieru::to_chieru_utf8);
+}
+
+void ChieruBatch::fromChieru(const std::string_view* messages, std::size_t count) {
+    translate(messages, count, chieru::from_chieru_utf8_bound, chieru::from_chieru_utf8);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file chieru_batch.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Translation of many short utf-8 messages into one shared buffer
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Translates a batch of utf-8 messages at once, writing every result into
+ *          one arena owned by the batch
+ *
+ * Results are views into the arena, valid until the next translation or clear().
+ * The arena grows to the worst case of each message as it is met, and is never
+ * zero-filled. It keeps its capacity between batches, as does the index, so a
+ * batch reused for messages of similar size doesn't allocate at all.
+ */
+class ChieruBatch {
+ public:
+    /**
+     * @brief Translate count utf-8 messages into utf-8 Chieru, replacing the
+     *          results of the last batch
+     */
+    void toChieru(const std::string_view* messages, std::size_t count);
+
+    /**
+     * @brief Translate count utf-8 Chieru messages back into utf-8, replacing
+     *          the results of the last batch
+     */
+    void fromChieru(const std::string_view* messages, std::size_t count);
+
+    template <typename Container>
+    void toChieru(const Container& messages) {
+        toChieru(messages.data(), messages.size());
+    }
+
+    template <typename Container>
+    void fromChieru(const Container& messages) {
+        fromChieru(messages.data(), messages.size());
+    }
+
+    std::size_t size() const { return m_results.size(); }
+    bool empty() const { return m_results.empty(); }
+
+    /**
+     * @brief The result of the i-th message
+     */
+    std::string_view operator[](std::size_t i) const {
+        return std::string_view(m_arena.get() + m_results[i].offset, m_results[i].length);
+    }
+
+    /**
+     * @brief Drop the results, keeping the memory for the next batch
+     */
+    void clear() { m_results.clear(); }
+
+ private:
+    struct Result {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    template <typename Bound, typename Translate>
+    void translate(const std::string_view* messages, std::size_t count,
+                   Bound bound_of, Translate translate_one);
+
+    // Grow the arena to size bytes, keeping the first used of them
+    void reserve(std::size_t used, std::size_t size);
+
+    std::unique_ptr<char[]> m_arena;
+    std::size_t m_capacity = 0;
+    std::vector<Result> m_results;
+};
@@ -0,0 +1,100 @@
+/**
+ * @file chieru_c.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the C interface, over the Qt-free core
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_c.h"
+
+#include "chieru_decode.h"
+#include "chieru_utf16.h"
+#include "chieru_utf8.h"
+
+static_assert(sizeof(char16_t) == sizeof(uint16_t), "utf-16 code units must be 16-bit");
+static_assert(static_cast<int>(chieru::DecodeError::UnknownGlyph) == CHIERU_UNKNOWN_GLYPH,
+              "chieru_error must follow chieru::DecodeError");
+
+namespace {
+
+std::u16string_view utf16(const uint16_t* text, size_t length) {
+    return std::u16string_view(reinterpret_cast<const char16_t*>(text), length);
+}
+
+chieru_status to_c(const chieru::DecodeStatus& status) {
+    chieru_status result;
+    result.error = static_cast<chieru_error>(status.error);
+    result.offset = status.offset;
+    result.length = status.length;
+    return result;
+}
+
+}  // namespace
+
+const char* chieru_error_name(chieru_error error) {
+    return chieru::decode_error_name(static_cast<chieru::DecodeError>(error));
+}
+
+size_t chieru_encode_utf8_bound(size_t length) {
+    return chieru::to_chieru_utf8_bound(length);
+}
+
+size_t chieru_encode_utf8(const char* text, size_t length, char* out) {
+    return chieru::to_chieru_utf8(std::string_view(text, length), out);
+}
+
+size_t chieru_decode_utf8_bound(size_t length) {
+    return chieru::from_chieru_utf8_bound(length);
+}
+
+size_t chieru_decode_utf8(const char* chieru, size_t length, char* out) {
+    return chieru::from_chieru_utf8(std::string_view(chieru, length), out);
+}
+
+chieru_status chieru_decode_utf8_strict(const char* chieru, size_t length, char* out) {
+    return to_c(chieru::decode_utf8(std::string_view(chieru, length), out));
+}
+
+chieru_status chieru_validate_utf8(const char* chieru, size_t length) {
+    return to_c(chieru::validate_utf8(std::string_view(chieru, length)));
+}
+
+size_t chieru_encode_utf16_length(const uint16_t* text, size_t length) {
+    return chieru::to_chieru_utf16_length(utf16(text, length));
+}
+
+size_t chieru_encode_utf16(const uint16_t* text, size_t length, uint16_t* out) {
+    return chieru::to_chieru_utf16(utf16(text, length), reinterpret_cast<char16_t*>(out));
+}
+
+size_t chieru_decode_utf16_bound(const uint16_t* chieru, size_t length) {
+    return chieru::from_chieru_utf16_bound(utf16(chieru, length));
+}
+
+size_t chieru_decode_utf16(const uint16_t* chieru, size_t length, char* out) {
+    return chieru::from_chieru_utf16(utf16(chieru, length), out);
+}
+
+chieru_status chieru_validate_utf16(const uint16_t* chieru, size_t length) {
+    return to_c(chieru::validate(reinterpret_cast<const char16_t*>(chieru), length));
+}
@@ -0,0 +1,104 @@
+/**
+ * @file chieru_c.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Plain C interface of the translation core, for other languages
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CHIERU_C_H
+#define CHIERU_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Define CHIERU_SHARED when building or linking the shared library */
+#if defined(CHIERU_SHARED)
+#  if defined(_WIN32)
+#    if defined(CHIERU_BUILDING)
+#      define CHIERU_API __declspec(dllexport)
+#    else
+#      define CHIERU_API __declspec(dllimport)
+#    endif
+#  else
+#    define CHIERU_API __attribute__((visibility("default")))
+#  endif
+#else
+#  define CHIERU_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief What is wrong with Chieru that doesn't decode, as chieru::DecodeError
+ */
+typedef enum chieru_error {
+    CHIERU_OK = 0,
+    CHIERU_NOT_CHIERU,
+    CHIERU_BAD_PREFIX,
+    CHIERU_ODD_LENGTH,
+    CHIERU_UNKNOWN_GLYPH
+} chieru_error;
+
+/**
+ * @brief Outcome of strict decoding or validation, as chieru::DecodeStatus
+ */
+typedef struct chieru_status {
+    chieru_error error;
+    size_t offset;  /* Of the first error, in bytes or code units of the input */
+    size_t length;  /* Bytes decoded */
+} chieru_status;
+
+/**
+ * @brief Name of the error, like "unknown glyph"
+ */
+CHIERU_API const char* chieru_error_name(chieru_error error);
+
+/* Utf-8 text and utf-8 Chieru. Buffers are sized by the _bound functions. */
+
+CHIERU_API size_t chieru_encode_utf8_bound(size_t length);
+CHIERU_API size_t chieru_encode_utf8(const char* text, size_t length, char* out);
+
+CHIERU_API size_t chieru_decode_utf8_bound(size_t length);
+/* Malformed words become "{ERROR}" */
+CHIERU_API size_t chieru_decode_utf8(const char* chieru, size_t length, char* out);
+/* Stops at the first error, out needs room for length bytes */
+CHIERU_API chieru_status chieru_decode_utf8_strict(const char* chieru, size_t length, char* out);
+CHIERU_API chieru_status chieru_validate_utf8(const char* chieru, size_t length);
+
+/* Utf-16 text and Chieru, like toChieru and fromChieru with the utf-8 codec */
+
+CHIERU_API size_t chieru_encode_utf16_length(const uint16_t* text, size_t length);
+CHIERU_API size_t chieru_encode_utf16(const uint16_t* text, size_t length, uint16_t* out);
+
+/* Decodes into the utf-8 bytes the words were made of */
+CHIERU_API size_t chieru_decode_utf16_bound(const uint16_t* chieru, size_t length);
+CHIERU_API size_t chieru_decode_utf16(const uint16_t* chieru, size_t length, char* out);
+CHIERU_API chieru_status chieru_validate_utf16(const uint16_t* chieru, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CHIERU_C_H */
@@ -0,0 +1,28 @@
+# Qt-free core of the translator, shared by every target that translates, and
+# built on its own as a library by chieru_core.pro
+
+INCLUDEPATH += $$PWD
+
+# "qmake CONFIG+=chieru_stats" counts and times the hot paths, see chieru_stats.h
+chieru_stats: DEFINES += CHIERU_STATS
+
+SOURCES += \
+    $$PWD/chieru_batch.cpp \
+    $$PWD/chieru_decode.cpp \
+    $$PWD/chieru_kernels.cpp \
+    $$PWD/chieru_scan.cpp \
+    $$PWD/chieru_stats.cpp \
+    $$PWD/chieru_stream.cpp \
+    $$PWD/chieru_utf16.cpp \
+    $$PWD/chieru_utf8.cpp
+
+HEADERS += \
+    $$PWD/chieru_alphabet.h \
+    $$PWD/chieru_batch.h \
+    $$PWD/chieru_decode.h \
+    $$PWD/chieru_kernels.h \
+    $$PWD/chieru_scan.h \
+    $$PWD/chieru_stats.h \
+    $$PWD/chieru_stream.h \
+    $$PWD/chieru_utf16.h \
+    $$PWD/chieru_utf8.h
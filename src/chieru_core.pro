@@ -0,0 +1,31 @@
+# The Qt-free translation core as a library, with a C interface (chieru_c.h)
+# for services and other languages that don't want to link Qt
+#
+# Shares the source directory with translator.pro, so build it out of source:
+#   mkdir build-core && cd build-core && qmake ../chieru_core.pro && make
+#
+# A static library by default, "qmake CONFIG+=chieru_shared" for a shared one,
+# whose users define CHIERU_SHARED as well.
+
+TEMPLATE = lib
+QT =
+
+CONFIG += c++17
+CONFIG -= qt
+
+TARGET = chieru_core
+
+chieru_shared {
+    CONFIG += shared hide_symbols
+    DEFINES += CHIERU_SHARED CHIERU_BUILDING
+} else {
+    CONFIG += staticlib
+}
+
+SOURCES += \
+    chieru_c.cpp
+
+HEADERS += \
+    chieru_c.h
+
+include(chieru_core.pri)
@@ -0,0 +1,208 @@
+/**
+ * @file chieru_decode.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of strict decoding and validation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_decode.h"
+
+#include <algorithm>
+
+#include "chieru_kernels.h"
+#include "chieru_utf8.h"
+
+namespace chieru {
+
+namespace {
+
+constexpr char16_t kHeader[] = u"切噜～♪";
+constexpr std::size_t kHeaderLength = 4;
+
+// Validation decodes into this much stack, chunk by chunk
+constexpr std::size_t kScratchSize = 512;
+
+DecodeStatus failure(DecodeError error, std::size_t offset, std::size_t length = 0) {
+    DecodeStatus status;
+    status.error = error;
+    status.offset = offset;
+    status.length = length;
+    return status;
+}
+
+// Decoders of an even count of glyphs into dst, or only checking them when dst
+// is nullptr. They return the offset of the first invalid glyph, or length.
+std::size_t decode_glyphs(const char16_t* src, std::size_t length, unsigned char* dst) {
+    if (dst) return decode_nibbles(src, length, dst);
+
+    unsigned char scratch[kScratchSize];
+    for (std::size_t i = 0; i < length; i += kScratchSize * 2) {
+        std::size_t chunk = std::min(length - i, kScratchSize * 2);
+        std::size_t decoded = decode_nibbles(src + i, chunk, scratch);
+        if (decoded != chunk) return i + decoded;
+    }
+    return length;
+}
+
+std::size_t decode_glyphs_utf8(const char* src, std::size_t length, unsigned char* dst) {
+    if (dst) return decode_nibbles_utf8(src, length, dst);
+
+    unsigned char scratch[kScratchSize];
+    for (std::size_t i = 0; i < length; i += kScratchSize * 6) {
+        std::size_t chunk = std::min(length - i, kScratchSize * 6);
+        std::size_t decoded = decode_nibbles_utf8(src + i, chunk, scratch);
+        if (decoded != chunk) return i + decoded;
+    }
+    return length;
+}
+
+bool is_glyph_utf8(const char* src) {
+    auto byte = [src](int i) { return static_cast<unsigned char>(src[i]); };
+    // Every glyph takes three bytes
+    if ((byte(0) & 0xF0) != 0xE0 || (byte(1) & 0xC0) != 0x80 || (byte(2) & 0xC0) != 0x80)
+        return false;
+    char16_t unit = static_cast<char16_t>((byte(0) & 0x0F) << 12 | (byte(1) & 0x3F) << 6 |
+                                          (byte(2) & 0x3F));
+    return ChieruAlphabet::nibble(unit) >= 0;
+}
+
+DecodeStatus check_word(const char16_t* word, std::size_t length, unsigned char* dst) {
+    if (length == 0 || word[0] != kGlyphs[0]) return failure(DecodeError::BadPrefix, 0);
+
+    // Bad glyphs are reported before a bad length, as they are what went wrong
+    std::size_t glyphs = length - 1;
+    std::size_t paired = glyphs & ~std::size_t(1);
+    std::size_t decoded = decode_glyphs(word + 1, paired, dst);
+    if (decoded != paired) return failure(DecodeError::UnknownGlyph, 1 + decoded, decoded / 2);
+
+    if (glyphs != paired && ChieruAlphabet::nibble(word[length - 1]) < 0)
+        return failure(DecodeError::UnknownGlyph, length - 1, paired / 2);
+    if (glyphs != paired || glyphs == 0) return failure(DecodeError::OddLength, 0, paired / 2);
+
+    DecodeStatus status;
+    status.length = paired / 2;
+    return status;
+}
+
+DecodeStatus check_word_utf8(const char* word, std::size_t length, unsigned char* dst) {
+    if (std::string_view(word, length).substr(0, kUtf8WordHead.size()) != kUtf8WordHead)
+        return failure(DecodeError::BadPrefix, 0);
+
+    std::size_t head = kUtf8WordHead.size();
+    std::size_t glyphs = length - head;
+    std::size_t paired = glyphs / 6 * 6;
+    std::size_t decoded = decode_glyphs_utf8(word + head, paired, dst);
+    if (decoded != paired) return failure(DecodeError::UnknownGlyph, head + decoded, decoded / 6);
+
+    // One glyph left over makes the length odd, anything else is garbage
+    std::size_t rest = head + paired;
+    while (rest + 3 <= length && is_glyph_utf8(word + rest)) rest += 3;
+    if (rest != length) return failure(DecodeError::UnknownGlyph, rest, paired / 6);
+    if (paired != glyphs || glyphs == 0) return failure(DecodeError::OddLength, 0, paired / 6);
+
+    DecodeStatus status;
+    status.length = paired / 6;
+    return status;
+}
+
+}  // namespace
+
+const char* decode_error_name(DecodeError error) {
+    switch (error) {
+    case DecodeError::None:
+        return "ok";
+    case DecodeError::NotChieru:
+        return "not chieru";
+    case DecodeError::BadPrefix:
+        return "bad prefix";
+    case DecodeError::OddLength:
+        return "odd length";
+    case DecodeError::UnknownGlyph:
+        return "unknown glyph";
+    }
+    return "unknown error";
+}
+
+DecodeStatus decode_word(const char16_t* word, std::size_t length, unsigned char* dst) {
+    return check_word(word, length, dst);
+}
+
+DecodeStatus decode_word_utf8(const char* word, std::size_t length, unsigned char* dst) {
+    return check_word_utf8(word, length, dst);
+}
+
+DecodeStatus validate(const char16_t* chieru, std::size_t length) {
+    if (length < kHeaderLength || !std::equal(kHeader, kHeader + kHeaderLength, chieru))
+        return failure(DecodeError::NotChieru, 0);
+
+    const char16_t* end = chieru + length;
+    for (const char16_t* word = chieru + kHeaderLength;; ) {
+        const char16_t* separator = find_separator(word, end);
+        if (separator != word) {
+            DecodeStatus status = check_word(word, static_cast<std::size_t>(separator - word),
+                                             nullptr);
+            if (!status) return failure(status.error, status.offset + (word - chieru));
+        }
+        if (separator == end) break;
+        word = separator + 1;
+    }
+    return DecodeStatus();
+}
+
+DecodeStatus validate_utf8(std::string_view chieru) {
+    return decode_utf8(chieru, nullptr);
+}
+
+DecodeStatus decode_utf8(std::string_view chieru, char* dst) {
+    if (chieru.substr(0, kUtf8Header.size()) != kUtf8Header)
+        return failure(DecodeError::NotChieru, 0);
+
+    // Without dst nothing is written, but lengths are still counted
+    std::size_t written = 0;
+    const char* begin = chieru.data();
+    const char* end = begin + chieru.size();
+    for (const char* word = begin + kUtf8Header.size();; ) {
+        const char* separator = find_separator_utf8(word, end);
+        if (separator != word) {
+            unsigned char* out = dst ? reinterpret_cast<unsigned char*>(dst + written) : nullptr;
+            DecodeStatus status = check_word_utf8(word, static_cast<std::size_t>(separator - word),
+                                                  out);
+            written += status.length;
+            if (!status) return failure(status.error, status.offset + (word - begin), written);
+        }
+        if (separator == end) break;
+
+        std::size_t separator_length = static_cast<std::size_t>(utf8_separator_length(separator, end));
+        if (dst) std::copy(separator, separator + separator_length, dst + written);
+        written += separator_length;
+        word = separator + separator_length;
+    }
+
+    DecodeStatus status;
+    status.length = written;
+    return status;
+}
+
+}  // namespace chieru
@@ -0,0 +1,106 @@
+/**
+ * @file chieru_decode.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Strict decoding and validation of Chieru, reporting what is wrong
+ *          and where instead of writing "{ERROR}"
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace chieru {
+
+/**
+ * @brief What makes a text not valid Chieru
+ */
+enum class DecodeError {
+    None,
+    NotChieru,      // The text doesn't start with "切噜～♪"
+    BadPrefix,      // A word doesn't start with '切'
+    OddLength,      // A word has an odd count of glyphs, or none at all
+    UnknownGlyph    // A word holds something that isn't a glyph
+};
+
+/**
+ * @brief Short name of the error, like "unknown glyph"
+ */
+const char* decode_error_name(DecodeError error);
+
+/**
+ * @brief Outcome of strict decoding or validation
+ */
+struct DecodeStatus {
+    DecodeError error = DecodeError::None;
+    // Where the error is, in code units (utf-16) or bytes (utf-8) of the input:
+    // the word for BadPrefix and OddLength, the glyph for UnknownGlyph
+    std::size_t offset = 0;
+    // Count of bytes written, up to the error
+    std::size_t length = 0;
+
+    constexpr bool ok() const { return error == DecodeError::None; }
+    constexpr explicit operator bool() const { return ok(); }
+};
+
+/**
+ * @brief Decode one word, '切' and its glyphs, stopping at the first error
+ *
+ * @param dst Output, must have room for length / 2 bytes
+ */
+DecodeStatus decode_word(const char16_t* word, std::size_t length, unsigned char* dst);
+
+/**
+ * @brief Decode one utf-8 word, '切' and its glyphs, stopping at the first
+ *          error
+ *
+ * @param dst Output, must have room for length / 6 bytes, or nullptr to only
+ *          check the word. May be word itself, bytes are written behind the
+ *          glyphs they are read from
+ */
+DecodeStatus decode_word_utf8(const char* word, std::size_t length, unsigned char* dst);
+
+/**
+ * @brief Check a whole Chieru text, header included, without writing it
+ *          anywhere
+ */
+DecodeStatus validate(const char16_t* chieru, std::size_t length);
+
+/**
+ * @brief Check a whole utf-8 Chieru text, header included, without writing it
+ *          anywhere
+ */
+DecodeStatus validate_utf8(std::string_view chieru);
+
+/**
+ * @brief Translate utf-8 Chieru back into utf-8 text like from_chieru_utf8,
+ *          but stop at the first error instead of writing "{ERROR}"
+ *
+ * @param dst Output, must have room for chieru.size() bytes
+ */
+DecodeStatus decode_utf8(std::string_view chieru, char* dst);
+
+}  // namespace chieru
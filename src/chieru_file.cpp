@@ -0,0 +1,188 @@
+/**
+ * @file chieru_file.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of file translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_file.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFuture>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <cstring>
+#include <string_view>
+
+#include "chieru_kernels.h"
+#include "chieru_utf8.h"
+
+namespace {
+
+// Pieces are at least this large, smaller files stay on one thread
+const qint64 kMinPieceSize = 4 << 20;
+
+struct Piece {
+    std::string_view input;
+    std::size_t offset;     // In the output
+    std::size_t length;
+};
+
+/**
+ * @brief Cut text into at most count pieces of about the same size, each but
+ *          the last ending right after a separator
+ */
+QVector<Piece> cut(std::string_view text, int count) {
+    QVector<Piece> pieces;
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+
+    const char* piece_begin = begin;
+    for (int i = 1; i < count; ++i) {
+        const char* target = begin + static_cast<qint64>(text.size()) * i / count;
+        if (target < piece_begin) continue;
+
+        const char* separator = chieru::find_separator_utf8(target, end);
+        if (separator == end) break;
+
+        const char* piece_end = separator + chieru::utf8_separator_length(separator, end);
+        pieces.push_back({std::string_view(piece_begin, static_cast<std::size_t>(piece_end - piece_begin)),
+                          0, 0});
+        piece_begin = piece_end;
+    }
+    pieces.push_back({std::string_view(piece_begin, static_cast<std::size_t>(end - piece_begin)),
+                      0, 0});
+    return pieces;
+}
+
+/**
+ * @brief Run fn over every piece on the pool, and wait for all of them
+ */
+template <typename Fn>
+void for_each_piece(QThreadPool* pool, QVector<Piece>& pieces, Fn fn) {
+    if (pieces.size() == 1) {
+        fn(pieces.front());
+        return;
+    }
+
+    QVector<QFuture<void>> futures;
+    for (Piece& piece : pieces)
+        futures.push_back(QtConcurrent::run(pool, [&fn, &piece]() { fn(piece); }));
+    for (QFuture<void>& future : futures) future.waitForFinished();
+}
+
+}  // namespace
+
+double ChieruFileTranslator::Report::megabytesPerSecond() const {
+    if (nanoseconds <= 0) return 0;
+    return static_cast<double>(input_bytes) / (1 << 20) / (nanoseconds / 1e9);
+}
+
+ChieruFileTranslator::ChieruFileTranslator(Direction direction, int threads)
+    : m_direction(direction) {
+    if (threads > 0) m_pool.setMaxThreadCount(threads);
+}
+
+bool ChieruFileTranslator::translate(const QString& input_name, const QString& output_name) {
+    QElapsedTimer timer;
+    timer.start();
+    m_report = Report();
+
+    QFile input(input_name);
+    if (!input.open(QIODevice::ReadOnly)) {
+        m_error = input_name + ": " + input.errorString();
+        return false;
+    }
+
+    // Empty files can't be mapped
+    qint64 input_size = input.size();
+    uchar* mapped = input_size ? input.map(0, input_size) : nullptr;
+    if (input_size && !mapped) {
+        m_error = input_name + ": " + input.errorString();
+        return false;
+    }
+    std::string_view text(reinterpret_cast<const char*>(mapped), static_cast<std::size_t>(input_size));
+
+    // What goes before the pieces: the header, or what isn't Chieru gets
+    std::string_view head = chieru::kUtf8Header;
+    if (m_direction == FromChieru) {
+        if (text.substr(0, chieru::kUtf8Header.size()) == chieru::kUtf8Header) {
+            head = std::string_view();
+            text.remove_prefix(chieru::kUtf8Header.size());
+        } else {
+            head = chieru::kUtf8NotChieru;
+            text = std::string_view();
+        }
+    }
+
+    int count = static_cast<int>(qMin<qint64>(static_cast<qint64>(text.size()) / kMinPieceSize,
+                                              m_pool.maxThreadCount() * 4));
+    QVector<Piece> pieces = cut(text, qMax(count, 1));
+
+    // First pass: the size of every translated piece, which places it
+    bool to_chieru = m_direction == ToChieru;
+    for_each_piece(&m_pool, pieces, [to_chieru](Piece& piece) {
+        piece.length = to_chieru ? chieru::to_chieru_utf8_body_length(piece.input)
+                                 : chieru::from_chieru_utf8_body_length(piece.input);
+    });
+
+    std::size_t total = head.size();
+    for (Piece& piece : pieces) {
+        piece.offset = total;
+        total += piece.length;
+    }
+
+    QFile output(output_name);
+    if (!output.open(QIODevice::ReadWrite | QIODevice::Truncate) ||
+        !output.resize(static_cast<qint64>(total))) {
+        m_error = output_name + ": " + output.errorString();
+        return false;
+    }
+    uchar* out = total ? output.map(0, static_cast<qint64>(total)) : nullptr;
+    if (total && !out) {
+        m_error = output_name + ": " + output.errorString();
+        return false;
+    }
+
+    // Second pass: every piece straight into its place
+    if (!head.empty()) std::memcpy(out, head.data(), head.size());
+    for_each_piece(&m_pool, pieces, [to_chieru, out](Piece& piece) {
+        char* dst = reinterpret_cast<char*>(out) + piece.offset;
+        if (to_chieru)
+            chieru::to_chieru_utf8_body(piece.input, dst);
+        else
+            chieru::from_chieru_utf8_body_exact(piece.input, dst);
+    });
+
+    if (out) output.unmap(out);
+    output.close();
+    if (mapped) input.unmap(mapped);
+
+    m_report.input_bytes = input_size;
+    m_report.output_bytes = static_cast<qint64>(total);
+    m_report.pieces = pieces.size();
+    m_report.nanoseconds = timer.nsecsElapsed();
+    return true;
+}
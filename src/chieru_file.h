@@ -0,0 +1,77 @@
+/**
+ * @file chieru_file.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Translation of whole files through memory maps
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * @brief Translates a utf-8 file into another one, both memory mapped
+ *
+ * The input is cut right after separators into pieces, and every piece is
+ * sized first, which places its translation in the output. The output file is
+ * then grown to the total size and mapped, and every piece translated straight
+ * into its place. Both passes run on a pool of threads, and as every piece has
+ * its own place the output comes out in order.
+ */
+class ChieruFileTranslator {
+ public:
+    enum Direction {
+        ToChieru,
+        FromChieru
+    };
+
+    struct Report {
+        qint64 input_bytes = 0;
+        qint64 output_bytes = 0;
+        int pieces = 0;
+        qint64 nanoseconds = 0;
+
+        // Of the input
+        double megabytesPerSecond() const;
+    };
+
+    /**
+     * @param threads Count of threads, 0 for one per core
+     */
+    explicit ChieruFileTranslator(Direction direction, int threads = 0);
+
+    /**
+     * @brief Translate the input file into the output file, which is replaced
+     */
+    bool translate(const QString& input, const QString& output);
+
+    const Report& report() const { return m_report; }
+    QString errorString() const { return m_error; }
+
+ private:
+    Direction m_direction;
+    QThreadPool m_pool;
+    Report m_report;
+    QString m_error;
+};
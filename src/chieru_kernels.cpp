@@ -0,0 +1,713 @@
+/**
+ * @file chieru_kernels.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Scalar and SIMD implementation of the Chieru kernels
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_kernels.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CHIERU_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC lets every function use every intrinsic
+#define CHIERU_TARGET(isa)
+#else
+#define CHIERU_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace chieru {
+
+namespace {
+
+// Byte halves of kGlyphs, laid out for byte shuffles
+struct GlyphBytes {
+    alignas(16) uint8_t low[16];
+    alignas(16) uint8_t high[16];
+
+    constexpr GlyphBytes() : low(), high() {
+        for (int i = 0; i < 16; ++i) {
+            low[i] = static_cast<uint8_t>(kGlyphs[i] & 0xFF);
+            high[i] = static_cast<uint8_t>(kGlyphs[i] >> 8);
+        }
+    }
+};
+
+constexpr GlyphBytes kGlyphBytes;
+
+// The decoders look glyphs up in the perfect hash of the alphabet, see Alphabet
+constexpr uint16_t kHashMultiplier = ChieruAlphabet::kHashMultiplier;
+constexpr const GlyphHashTable& kGlyphHash = ChieruAlphabet::kHashTable;
+static_assert(ChieruAlphabet::nibble(kGlyphs[15]) == 15 && ChieruAlphabet::nibble(u'a') < 0,
+              "glyph hash is broken");
+
+// Ascii separators as a 16x8 bitmap: row[c & 15] has bit (c >> 4) set when c
+// separates words, with bit[c >> 4] holding that bit for shuffle lookups
+struct AsciiSeparatorRows {
+    alignas(16) uint8_t row[16];
+    alignas(16) uint8_t bit[16];
+
+    constexpr AsciiSeparatorRows() : row(), bit() {
+        for (int h = 0; h < 8; ++h) {
+            bit[h] = static_cast<uint8_t>(1 << h);
+            for (int l = 0; l < 16; ++l)
+                if (is_separator(static_cast<char16_t>(h << 4 | l)))
+                    row[l] |= static_cast<uint8_t>(1 << h);
+        }
+    }
+};
+
+constexpr AsciiSeparatorRows kAsciiSeparatorRows;
+
+// High bytes of the pages holding non-ascii separators
+constexpr uint8_t kSymbolPages[] = {0x20, 0x30, 0xFF};
+
+constexpr bool symbol_pages_are_complete() {
+    for (int page = 1; page < 256; ++page) {
+        if (kSeparatorTable.page[page] == 0) continue;
+        bool listed = false;
+        for (uint8_t symbol_page : kSymbolPages) listed |= symbol_page == page;
+        if (!listed) return false;
+    }
+    return true;
+}
+static_assert(symbol_pages_are_complete(), "kSymbolPages misses a separator page");
+
+// Utf-8 form of the glyphs of every byte, low nibble first
+struct Utf8ByteGlyphs {
+    char bytes[256][6];
+
+    constexpr Utf8ByteGlyphs() : bytes() {
+        for (int byte = 0; byte < 256; ++byte) {
+            for (int half = 0; half < 2; ++half) {
+                char16_t glyph = kGlyphs[half ? byte >> 4 : byte & 15];
+                char* out = bytes[byte] + half * 3;
+                out[0] = static_cast<char>(0xE0 | glyph >> 12);
+                out[1] = static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+                out[2] = static_cast<char>(0x80 | (glyph & 0x3F));
+            }
+        }
+    }
+};
+
+constexpr Utf8ByteGlyphs kUtf8ByteGlyphs;
+
+const char* find_separator_utf8_scalar(const char* begin, const char* end) {
+    while (begin != end && !utf8_separator_length(begin, end)) ++begin;
+    return begin;
+}
+
+// '切' in utf-8
+constexpr unsigned char kWordHead[3] = {0xE5, 0x88, 0x87};
+
+const char* find_word_head_utf8_scalar(const char* begin, const char* end) {
+    while (end - begin >= 3) {
+        const void* lead = std::memchr(begin, kWordHead[0], static_cast<std::size_t>(end - begin - 2));
+        if (!lead) break;
+
+        begin = static_cast<const char*>(lead);
+        if (static_cast<unsigned char>(begin[1]) == kWordHead[1] &&
+            static_cast<unsigned char>(begin[2]) == kWordHead[2])
+            return begin;
+        ++begin;
+    }
+    return end;
+}
+
+const char16_t* find_separator_scalar(const char16_t* begin, const char16_t* end) {
+    while (begin != end && !is_separator(*begin)) ++begin;
+    return begin;
+}
+
+void encode_nibbles_scalar(const unsigned char* src, std::size_t length, char16_t* dst) {
+    ChieruAlphabet::encode(src, length, dst);
+}
+
+std::size_t decode_nibbles_scalar(const char16_t* src, std::size_t length, unsigned char* dst) {
+    return ChieruAlphabet::decode(src, length, dst);
+}
+
+#ifdef CHIERU_X86
+
+KernelIsa detect_isa() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return KernelIsa::Scalar;
+    __cpuid(info, 1);
+    bool sse41 = info[2] & (1 << 19);
+    bool osxsave = info[2] & (1 << 27);
+    bool avx = info[2] & (1 << 28);
+    __cpuidex(info, 7, 0);
+    bool avx2 = info[1] & (1 << 5);
+    // The os has to save the ymm registers as well
+    if (avx2 && avx && osxsave && (_xgetbv(0) & 6) == 6) return KernelIsa::AVX2;
+    return sse41 ? KernelIsa::SSE41 : KernelIsa::Scalar;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return KernelIsa::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return KernelIsa::SSE41;
+    return KernelIsa::Scalar;
+#endif
+}
+
+inline int lowest_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Look up 16 nibbles (one per byte) and store the 16 glyphs
+CHIERU_TARGET("sse4.1")
+inline void store_glyphs_sse41(__m128i nibbles, __m128i glyph_low, __m128i glyph_high,
+                               char16_t* dst) {
+    __m128i low = _mm_shuffle_epi8(glyph_low, nibbles);
+    __m128i high = _mm_shuffle_epi8(glyph_high, nibbles);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(low, high));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(low, high));
+}
+
+CHIERU_TARGET("sse4.1")
+void encode_nibbles_sse41(const unsigned char* src, std::size_t length, char16_t* dst) {
+    const __m128i glyph_low = _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.low));
+    const __m128i glyph_high = _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.high));
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16, dst += 32) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i low = _mm_and_si128(bytes, nibble_mask);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+
+        // Interleave so that nibbles are in output order: lo0 hi0 lo1 hi1 ...
+        store_glyphs_sse41(_mm_unpacklo_epi8(low, high), glyph_low, glyph_high, dst);
+        store_glyphs_sse41(_mm_unpackhi_epi8(low, high), glyph_low, glyph_high, dst + 16);
+    }
+
+    encode_nibbles_scalar(src + i, length - i, dst);
+}
+
+CHIERU_TARGET("avx2")
+void encode_nibbles_avx2(const unsigned char* src, std::size_t length, char16_t* dst) {
+    const __m256i glyph_low = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.low)));
+    const __m256i glyph_high = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.high)));
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32, dst += 64) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i low = _mm256_and_si256(bytes, nibble_mask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask);
+
+        // Unpacking works inside 128-bit lanes, so nibbles0 holds the nibbles of
+        // bytes 0-7 and 16-23, nibbles1 those of bytes 8-15 and 24-31
+        __m256i nibbles0 = _mm256_unpacklo_epi8(low, high);
+        __m256i nibbles1 = _mm256_unpackhi_epi8(low, high);
+
+        __m256i low0 = _mm256_shuffle_epi8(glyph_low, nibbles0);
+        __m256i high0 = _mm256_shuffle_epi8(glyph_high, nibbles0);
+        __m256i low1 = _mm256_shuffle_epi8(glyph_low, nibbles1);
+        __m256i high1 = _mm256_shuffle_epi8(glyph_high, nibbles1);
+
+        // Glyphs of bytes 0-3|16-19, 4-7|20-23, 8-11|24-27, 12-15|28-31
+        __m256i glyphs0 = _mm256_unpacklo_epi8(low0, high0);
+        __m256i glyphs1 = _mm256_unpackhi_epi8(low0, high0);
+        __m256i glyphs2 = _mm256_unpacklo_epi8(low1, high1);
+        __m256i glyphs3 = _mm256_unpackhi_epi8(low1, high1);
+
+        __m256i* out = reinterpret_cast<__m256i*>(dst);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(glyphs0, glyphs1, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(glyphs2, glyphs3, 0x20));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(glyphs0, glyphs1, 0x31));
+        _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(glyphs2, glyphs3, 0x31));
+    }
+
+    encode_nibbles_sse41(src + i, length - i, dst);
+}
+
+// Turn glyph hashes (one per byte, 0-31) into nibbles, 0x80 when unused
+CHIERU_TARGET("sse4.1")
+inline __m128i hash_to_nibble_sse41(__m128i hashes, __m128i nibble_low, __m128i nibble_high) {
+    // Bit 4 of every hash selects the table, moved up to where blendv looks
+    return _mm_blendv_epi8(_mm_shuffle_epi8(nibble_low, hashes),
+                           _mm_shuffle_epi8(nibble_high, hashes),
+                           _mm_slli_epi16(hashes, 3));
+}
+
+CHIERU_TARGET("sse4.1")
+std::size_t decode_nibbles_sse41(const char16_t* src, std::size_t length, unsigned char* dst) {
+    const __m128i glyph_low = _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.low));
+    const __m128i glyph_high = _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.high));
+    const __m128i nibble_low = _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphHash.nibble));
+    const __m128i nibble_high =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphHash.nibble + 16));
+    const __m128i multiplier = _mm_set1_epi16(kHashMultiplier);
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    const __m128i nibble_weights = _mm_set1_epi16(0x1001);  // low * 1 + high * 16
+
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16, dst += 8) {
+        __m128i units0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i units1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+
+        __m128i hashes = _mm_packus_epi16(_mm_srli_epi16(_mm_mullo_epi16(units0, multiplier), 11),
+                                          _mm_srli_epi16(_mm_mullo_epi16(units1, multiplier), 11));
+        __m128i nibbles = hash_to_nibble_sse41(hashes, nibble_low, nibble_high);
+
+        // A unit is valid when its nibble exists and maps back to the unit
+        __m128i expected_low = _mm_shuffle_epi8(glyph_low, nibbles);
+        __m128i expected_high = _mm_shuffle_epi8(glyph_high, nibbles);
+        __m128i actual_low = _mm_packus_epi16(_mm_and_si128(units0, low_byte),
+                                              _mm_and_si128(units1, low_byte));
+        __m128i actual_high = _mm_packus_epi16(_mm_srli_epi16(units0, 8),
+                                               _mm_srli_epi16(units1, 8));
+        __m128i matched = _mm_and_si128(_mm_cmpeq_epi8(expected_low, actual_low),
+                                        _mm_cmpeq_epi8(expected_high, actual_high));
+        unsigned valid = static_cast<unsigned>(_mm_movemask_epi8(matched)) &
+                         ~static_cast<unsigned>(_mm_movemask_epi8(nibbles));
+        if (valid != 0xFFFF) break;
+
+        __m128i bytes = _mm_maddubs_epi16(nibbles, nibble_weights);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(bytes, bytes));
+    }
+
+    // Also pinpoints the first invalid unit of a rejected block
+    std::size_t tail = decode_nibbles_scalar(src + i, length - i, dst);
+    return i + tail;
+}
+
+CHIERU_TARGET("avx2")
+std::size_t decode_nibbles_avx2(const char16_t* src, std::size_t length, unsigned char* dst) {
+    const __m256i glyph_low = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.low)));
+    const __m256i glyph_high = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphBytes.high)));
+    const __m256i nibble_low = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphHash.nibble)));
+    const __m256i nibble_high = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kGlyphHash.nibble + 16)));
+    const __m256i multiplier = _mm256_set1_epi16(kHashMultiplier);
+    const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+    const __m256i nibble_weights = _mm256_set1_epi16(0x1001);
+
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32, dst += 16) {
+        __m256i units0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i units1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+
+        // Packing works inside 128-bit lanes, the permutation puts the quarters
+        // back into unit order
+        __m256i hashes = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(units0, multiplier), 11),
+                                _mm256_srli_epi16(_mm256_mullo_epi16(units1, multiplier), 11)),
+            0xD8);
+        __m256i nibbles = _mm256_blendv_epi8(_mm256_shuffle_epi8(nibble_low, hashes),
+                                             _mm256_shuffle_epi8(nibble_high, hashes),
+                                             _mm256_slli_epi16(hashes, 3));
+
+        __m256i expected_low = _mm256_shuffle_epi8(glyph_low, nibbles);
+        __m256i expected_high = _mm256_shuffle_epi8(glyph_high, nibbles);
+        __m256i actual_low = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_and_si256(units0, low_byte),
+                                _mm256_and_si256(units1, low_byte)),
+            0xD8);
+        __m256i actual_high = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_srli_epi16(units0, 8), _mm256_srli_epi16(units1, 8)),
+            0xD8);
+        __m256i matched = _mm256_and_si256(_mm256_cmpeq_epi8(expected_low, actual_low),
+                                           _mm256_cmpeq_epi8(expected_high, actual_high));
+        unsigned valid = static_cast<unsigned>(_mm256_movemask_epi8(matched)) &
+                         ~static_cast<unsigned>(_mm256_movemask_epi8(nibbles));
+        if (valid != 0xFFFFFFFFu) break;
+
+        __m256i bytes = _mm256_maddubs_epi16(nibbles, nibble_weights);
+        bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(bytes));
+    }
+
+    return i + decode_nibbles_sse41(src + i, length - i, dst);
+}
+
+// Mask of the separator candidates among 16 units packed into bytes: exact
+// for ascii, any unit on a page holding Chinese symbols otherwise
+CHIERU_TARGET("sse4.1")
+inline unsigned separator_candidates_sse41(__m128i units0, __m128i units1) {
+    const __m128i rows = _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.row));
+    const __m128i bits = _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.bit));
+
+    // Units above 0xFF are clamped to 0xFF, whose row lookup yields zero
+    const __m128i clamp = _mm_set1_epi16(0x00FF);
+    __m128i low = _mm_packus_epi16(_mm_min_epu16(units0, clamp), _mm_min_epu16(units1, clamp));
+    __m128i high = _mm_packus_epi16(_mm_srli_epi16(units0, 8), _mm_srli_epi16(units1, 8));
+
+    __m128i row = _mm_shuffle_epi8(rows, low);
+    __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(low, 4), _mm_set1_epi8(0x0F)));
+    __m128i not_ascii = _mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128());
+
+    __m128i symbol_page = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(high, _mm_set1_epi8(0x20)),
+                     _mm_cmpeq_epi8(high, _mm_set1_epi8(0x30))),
+        _mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(0xFF))));
+
+    return (~static_cast<unsigned>(_mm_movemask_epi8(not_ascii)) |
+            static_cast<unsigned>(_mm_movemask_epi8(symbol_page))) & 0xFFFF;
+}
+
+CHIERU_TARGET("sse4.1")
+const char16_t* find_separator_sse41(const char16_t* begin, const char16_t* end) {
+    for (; end - begin >= 16; begin += 16) {
+        unsigned candidates = separator_candidates_sse41(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + 8)));
+        for (; candidates; candidates &= candidates - 1) {
+            const char16_t* candidate = begin + lowest_bit(candidates);
+            if (is_separator(*candidate)) return candidate;
+        }
+    }
+    return find_separator_scalar(begin, end);
+}
+
+CHIERU_TARGET("avx2")
+const char16_t* find_separator_avx2(const char16_t* begin, const char16_t* end) {
+    const __m256i rows = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.row)));
+    const __m256i bits = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.bit)));
+    const __m256i clamp = _mm256_set1_epi16(0x00FF);
+
+    for (; end - begin >= 32; begin += 32) {
+        __m256i units0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        __m256i units1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + 16));
+
+        __m256i low = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_min_epu16(units0, clamp), _mm256_min_epu16(units1, clamp)),
+            0xD8);
+        __m256i high = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_srli_epi16(units0, 8), _mm256_srli_epi16(units1, 8)), 0xD8);
+
+        __m256i row = _mm256_shuffle_epi8(rows, low);
+        __m256i bit = _mm256_shuffle_epi8(
+            bits, _mm256_and_si256(_mm256_srli_epi16(low, 4), _mm256_set1_epi8(0x0F)));
+        __m256i not_ascii = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256());
+
+        __m256i symbol_page = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(high, _mm256_set1_epi8(0x20)),
+                            _mm256_cmpeq_epi8(high, _mm256_set1_epi8(0x30))),
+            _mm256_cmpeq_epi8(high, _mm256_set1_epi8(static_cast<char>(0xFF))));
+
+        unsigned candidates = ~static_cast<unsigned>(_mm256_movemask_epi8(not_ascii)) |
+                              static_cast<unsigned>(_mm256_movemask_epi8(symbol_page));
+        for (; candidates; candidates &= candidates - 1) {
+            const char16_t* candidate = begin + lowest_bit(candidates);
+            if (is_separator(*candidate)) return candidate;
+        }
+    }
+    return find_separator_sse41(begin, end);
+}
+
+// Mask of the separator candidates among 16 utf-8 bytes: exact for ascii, any
+// byte that may lead a Chinese symbol otherwise
+CHIERU_TARGET("sse4.1")
+inline unsigned utf8_separator_candidates_sse41(__m128i bytes, __m128i rows, __m128i bits) {
+    // Bytes from 0x80 up have their high bit set, which zeroes the row lookup
+    __m128i row = _mm_shuffle_epi8(rows, bytes);
+    __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F)));
+    __m128i not_ascii = _mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128());
+
+    __m128i symbol_lead = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xE2))),
+                     _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xE3)))),
+        _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xEF))));
+
+    return (~static_cast<unsigned>(_mm_movemask_epi8(not_ascii)) |
+            static_cast<unsigned>(_mm_movemask_epi8(symbol_lead))) & 0xFFFF;
+}
+
+CHIERU_TARGET("sse4.1")
+const char* find_separator_utf8_sse41(const char* begin, const char* end) {
+    const __m128i rows = _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.row));
+    const __m128i bits = _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.bit));
+
+    for (; end - begin >= 16; begin += 16) {
+        unsigned candidates = utf8_separator_candidates_sse41(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), rows, bits);
+        for (; candidates; candidates &= candidates - 1) {
+            const char* candidate = begin + lowest_bit(candidates);
+            if (utf8_separator_length(candidate, end)) return candidate;
+        }
+    }
+    return find_separator_utf8_scalar(begin, end);
+}
+
+CHIERU_TARGET("avx2")
+const char* find_separator_utf8_avx2(const char* begin, const char* end) {
+    const __m256i rows = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.row)));
+    const __m256i bits = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kAsciiSeparatorRows.bit)));
+
+    for (; end - begin >= 32; begin += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+        __m256i row = _mm256_shuffle_epi8(rows, bytes);
+        __m256i bit = _mm256_shuffle_epi8(
+            bits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F)));
+        __m256i not_ascii = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256());
+
+        __m256i symbol_lead = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0xE2))),
+                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0xE3)))),
+            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0xEF))));
+
+        unsigned candidates = ~static_cast<unsigned>(_mm256_movemask_epi8(not_ascii)) |
+                              static_cast<unsigned>(_mm256_movemask_epi8(symbol_lead));
+        for (; candidates; candidates &= candidates - 1) {
+            const char* candidate = begin + lowest_bit(candidates);
+            if (utf8_separator_length(candidate, end)) return candidate;
+        }
+    }
+    return find_separator_utf8_sse41(begin, end);
+}
+
+// Lead bytes of common CJK charactors are as frequent as '切' is rare, so all
+// three bytes are matched at once
+CHIERU_TARGET("sse4.1")
+const char* find_word_head_utf8_sse41(const char* begin, const char* end) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(kWordHead[0]));
+    const __m128i second = _mm_set1_epi8(static_cast<char>(kWordHead[1]));
+    const __m128i third = _mm_set1_epi8(static_cast<char>(kWordHead[2]));
+
+    for (; end - begin >= 18; begin += 16) {
+        __m128i matched = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), first),
+            _mm_and_si128(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + 1)), second),
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + 2)), third)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matched));
+        if (mask) return begin + lowest_bit(mask);
+    }
+    return find_word_head_utf8_scalar(begin, end);
+}
+
+CHIERU_TARGET("avx2")
+const char* find_word_head_utf8_avx2(const char* begin, const char* end) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(kWordHead[0]));
+    const __m256i second = _mm256_set1_epi8(static_cast<char>(kWordHead[1]));
+    const __m256i third = _mm256_set1_epi8(static_cast<char>(kWordHead[2]));
+
+    for (; end - begin >= 34; begin += 32) {
+        __m256i matched = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin)), first),
+            _mm256_and_si256(
+                _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + 1)),
+                                  second),
+                _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + 2)),
+                                  third)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matched));
+        if (mask) return begin + lowest_bit(mask);
+    }
+    return find_word_head_utf8_sse41(begin, end);
+}
+
+#else
+
+KernelIsa detect_isa() {
+    return KernelIsa::Scalar;
+}
+
+#endif
+
+std::atomic<KernelIsa>& current_isa() {
+    static std::atomic<KernelIsa> isa(detect_isa());
+    return isa;
+}
+
+}  // namespace
+
+KernelIsa kernel_isa() {
+    return current_isa().load(std::memory_order_relaxed);
+}
+
+void set_kernel_isa(KernelIsa isa) {
+    KernelIsa supported = detect_isa();
+    if (static_cast<int>(isa) > static_cast<int>(supported)) isa = supported;
+    current_isa().store(isa, std::memory_order_relaxed);
+}
+
+void encode_nibbles(const unsigned char* src, std::size_t length, char16_t* dst) {
+    switch (kernel_isa()) {
+#ifdef CHIERU_X86
+    case KernelIsa::AVX2:
+        encode_nibbles_avx2(src, length, dst);
+        return;
+    case KernelIsa::SSE41:
+        encode_nibbles_sse41(src, length, dst);
+        return;
+#endif
+    default:
+        encode_nibbles_scalar(src, length, dst);
+        return;
+    }
+}
+
+std::size_t decode_nibbles(const char16_t* src, std::size_t length, unsigned char* dst) {
+    switch (kernel_isa()) {
+#ifdef CHIERU_X86
+    case KernelIsa::AVX2:
+        return decode_nibbles_avx2(src, length, dst);
+    case KernelIsa::SSE41:
+        return decode_nibbles_sse41(src, length, dst);
+#endif
+    default:
+        return decode_nibbles_scalar(src, length, dst);
+    }
+}
+
+const char* find_separator_utf8(const char* begin, const char* end) {
+    switch (kernel_isa()) {
+#ifdef CHIERU_X86
+    case KernelIsa::AVX2:
+        return find_separator_utf8_avx2(begin, end);
+    case KernelIsa::SSE41:
+        return find_separator_utf8_sse41(begin, end);
+#endif
+    default:
+        return find_separator_utf8_scalar(begin, end);
+    }
+}
+
+const char* find_word_head_utf8(const char* begin, const char* end) {
+    switch (kernel_isa()) {
+#ifdef CHIERU_X86
+    case KernelIsa::AVX2:
+        return find_word_head_utf8_avx2(begin, end);
+    case KernelIsa::SSE41:
+        return find_word_head_utf8_sse41(begin, end);
+#endif
+    default:
+        return find_word_head_utf8_scalar(begin, end);
+    }
+}
+
+void encode_nibbles_utf8(const unsigned char* src, std::size_t length, char* dst) {
+    for (const unsigned char* end = src + length; src != end; ++src, dst += 6)
+        std::memcpy(dst, kUtf8ByteGlyphs.bytes[*src], 6);
+}
+
+std::size_t decode_nibbles_utf8(const char* src, std::size_t length, unsigned char* dst) {
+    auto nibble = [src](std::size_t i) {
+        auto byte = [src, i](int j) { return static_cast<unsigned char>(src[i + j]); };
+        // Every glyph takes three bytes
+        if ((byte(0) & 0xF0) != 0xE0 || (byte(1) & 0xC0) != 0x80 || (byte(2) & 0xC0) != 0x80)
+            return -1;
+        return ChieruAlphabet::nibble(static_cast<char16_t>((byte(0) & 0x0F) << 12 |
+                                                  (byte(1) & 0x3F) << 6 | (byte(2) & 0x3F)));
+    };
+
+    for (std::size_t i = 0; i < length; i += 6) {
+        int low = nibble(i);
+        if (low < 0) return i;
+        int high = nibble(i + 3);
+        if (high < 0) return i + 3;
+        *dst++ = static_cast<unsigned char>(low | high << 4);
+    }
+    return length;
+}
+
+std::size_t utf8_length(const char16_t* src, std::size_t length) {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        char16_t unit = src[i];
+        if (unit < 0x80) {
+            bytes += 1;
+        } else if (unit < 0x800) {
+            bytes += 2;
+        } else if (unit >= 0xD800 && unit < 0xE000) {
+            if (unit < 0xDC00 && i + 1 < length && src[i + 1] >= 0xDC00 && src[i + 1] < 0xE000) {
+                bytes += 4;
+                ++i;
+            } else {
+                bytes += 1;
+            }
+        } else {
+            bytes += 3;
+        }
+    }
+    return bytes;
+}
+
+std::size_t encode_utf8(const char16_t* src, std::size_t length, unsigned char* dst) {
+    unsigned char* out = dst;
+    for (std::size_t i = 0; i < length; ++i) {
+        char32_t code = src[i];
+        if (code < 0x80) {
+            *out++ = static_cast<unsigned char>(code);
+        } else if (code < 0x800) {
+            *out++ = static_cast<unsigned char>(0xC0 | code >> 6);
+            *out++ = static_cast<unsigned char>(0x80 | (code & 0x3F));
+        } else if (code >= 0xD800 && code < 0xE000) {
+            if (code < 0xDC00 && i + 1 < length && src[i + 1] >= 0xDC00 && src[i + 1] < 0xE000) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (src[++i] - 0xDC00);
+                *out++ = static_cast<unsigned char>(0xF0 | code >> 18);
+                *out++ = static_cast<unsigned char>(0x80 | ((code >> 12) & 0x3F));
+                *out++ = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+                *out++ = static_cast<unsigned char>(0x80 | (code & 0x3F));
+            } else {
+                *out++ = '?';
+            }
+        } else {
+            *out++ = static_cast<unsigned char>(0xE0 | code >> 12);
+            *out++ = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | (code & 0x3F));
+        }
+    }
+    return static_cast<std::size_t>(out - dst);
+}
+
+const char16_t* find_separator(const char16_t* begin, const char16_t* end) {
+    switch (kernel_isa()) {
+#ifdef CHIERU_X86
+    case KernelIsa::AVX2:
+        return find_separator_avx2(begin, end);
+    case KernelIsa::SSE41:
+        return find_separator_sse41(begin, end);
+#endif
+    default:
+        return find_separator_scalar(begin, end);
+    }
+}
+
+}  // namespace chieru
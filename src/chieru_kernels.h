@@ -0,0 +1,246 @@
+/**
+ * @file chieru_kernels.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Qt-free encoding kernels used by the Chieru translator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "chieru_alphabet.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chieru {
+
+/**
+ * @brief The dialect every translator speaks, the kernels below are tuned for it
+ */
+struct ChieruDialect {
+    // The 16 glyphs of Chieru, indexed by the nibble they stand for
+    static constexpr char16_t kGlyphs[16] = {
+        u'切', u'卟', u'叮', u'咧', u'哔', u'唎', u'啪', u'啰',
+        u'啵', u'嘭', u'噜', u'噼', u'巴', u'拉', u'蹦', u'铃'
+    };
+};
+
+using ChieruAlphabet = Alphabet<ChieruDialect>;
+
+inline constexpr const char16_t (&kGlyphs)[16] = ChieruDialect::kGlyphs;
+
+/**
+ * @brief Chinese symbols that separate words, besides the ascii symbols
+ */
+constexpr char16_t kSymbols[] =
+    u"！￥…（）—【】、；：‘’“”《》，。？～｀＃＄％＾＆＊－＿＝＋［］｛｝＼｜＇＂＜＞／";
+
+/**
+ * @brief Two-level bitmap telling separators from word charactors
+ *
+ * The high byte of a code unit picks a 256-bit page, the low byte a bit in it.
+ * Pages without any separator all share the empty page 0.
+ */
+struct SeparatorTable {
+    static constexpr int kMaxPages = 5;
+
+    uint8_t page[256];
+    uint32_t bits[kMaxPages][8];
+    int page_count;
+
+    constexpr SeparatorTable() : page(), bits(), page_count(1) {
+        for (char16_t ch = 0; ch < 0x80; ++ch)
+            if ((ch < 0x30) ||                      // before '0'
+                (ch > 0x39 && ch <= 0x40) ||        // between '9' and 'A'
+                (ch > 0x5A && ch <= 0x60) ||        // between 'Z' and 'a'
+                (ch > 0x7A))                        // after 'z' in ascii
+                mark(ch);
+
+        for (const char16_t* symbol = kSymbols; *symbol; ++symbol) mark(*symbol);
+    }
+
+    constexpr void mark(char16_t ch) {
+        if (page[ch >> 8] == 0) page[ch >> 8] = static_cast<uint8_t>(page_count++);
+        bits[page[ch >> 8]][(ch & 0xFF) >> 5] |= uint32_t(1) << (ch & 31);
+    }
+
+    constexpr bool contains(char16_t ch) const {
+        return (bits[page[ch >> 8]][(ch & 0xFF) >> 5] >> (ch & 31)) & 1;
+    }
+};
+
+inline constexpr SeparatorTable kSeparatorTable;
+static_assert(kSeparatorTable.page_count <= SeparatorTable::kMaxPages,
+              "separators span too many pages");
+
+/**
+ * @brief Whether the code unit separates words
+ */
+constexpr bool is_separator(char16_t ch) {
+    return kSeparatorTable.contains(ch);
+}
+
+/**
+ * @brief Instruction sets the kernels can be dispatched to
+ */
+enum class KernelIsa {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+/**
+ * @brief Get the instruction set picked for this cpu (detected once)
+ */
+KernelIsa kernel_isa();
+
+/**
+ * @brief Force the kernels to an instruction set, mostly for benchmarking
+ *
+ * @note Requests for an instruction set the cpu lacks fall back to the best
+ *          supported one
+ */
+void set_kernel_isa(KernelIsa isa);
+
+/**
+ * @brief Encode bytes into Chieru glyphs, low nibble first
+ *
+ * @param src Bytes to encode
+ * @param length Count of bytes in src
+ * @param dst Output, must have room for 2 * length code units
+ */
+void encode_nibbles(const unsigned char* src, std::size_t length, char16_t* dst);
+
+/**
+ * @brief Decode Chieru glyphs back into bytes, two glyphs (low nibble first)
+ *          per byte
+ *
+ * @param src Glyphs to decode
+ * @param length Count of code units in src, must be even
+ * @param dst Output, must have room for length / 2 bytes
+ * @return std::size_t Index of the first code unit that isn't a glyph, or
+ *          length when every unit is valid
+ */
+std::size_t decode_nibbles(const char16_t* src, std::size_t length, unsigned char* dst);
+
+/**
+ * @brief Count the bytes src takes in utf-8
+ *
+ * @note Lone surrogates count as the single '?' QTextCodec writes for them
+ */
+std::size_t utf8_length(const char16_t* src, std::size_t length);
+
+/**
+ * @brief Convert utf-16 into utf-8 the way QTextCodec does
+ *
+ * @param dst Output, must have room for utf8_length(src, length) bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t encode_utf8(const char16_t* src, std::size_t length, unsigned char* dst);
+
+/**
+ * @brief Find the first separator in [begin, end)
+ *
+ * @return const char16_t* The separator, or end if there is none
+ */
+const char16_t* find_separator(const char16_t* begin, const char16_t* end);
+
+/**
+ * @brief Cut [begin, end) into pieces that can be translated one by one, each
+ *          but the last ending right after the first separator past
+ *          piece_length code units
+ *
+ * @param on_piece Called with the length of every piece in order, once with 0
+ *          for an empty range
+ */
+template <typename PieceHandler>
+void cut_pieces(const char16_t* begin, const char16_t* end, std::size_t piece_length,
+                PieceHandler on_piece) {
+    const char16_t* position = begin;
+    while (static_cast<std::size_t>(end - position) > piece_length) {
+        const char16_t* separator = find_separator(position + piece_length, end);
+        if (separator == end) break;
+
+        on_piece(static_cast<std::size_t>(separator + 1 - position));
+        position = separator + 1;
+    }
+    on_piece(static_cast<std::size_t>(end - position));
+}
+
+/**
+ * @brief Length of the utf-8 separator starting at begin
+ *
+ * @return int 1 for ascii separators, 3 for Chinese symbols, 0 if begin
+ *          doesn't start a separator
+ */
+inline int utf8_separator_length(const char* begin, const char* end) {
+    auto byte = [begin](int i) { return static_cast<unsigned char>(begin[i]); };
+
+    if (byte(0) < 0x80) return is_separator(byte(0)) ? 1 : 0;
+
+    // Every Chinese symbol takes three bytes, led by 0xE2, 0xE3 or 0xEF
+    if ((byte(0) != 0xE2 && byte(0) != 0xE3 && byte(0) != 0xEF) || end - begin < 3 ||
+        (byte(1) & 0xC0) != 0x80 || (byte(2) & 0xC0) != 0x80)
+        return 0;
+    char16_t ch = static_cast<char16_t>((byte(0) & 0x0F) << 12 | (byte(1) & 0x3F) << 6 |
+                                        (byte(2) & 0x3F));
+    return is_separator(ch) ? 3 : 0;
+}
+
+/**
+ * @brief Find the first separator in the utf-8 text [begin, end)
+ *
+ * @return const char* The separator, or end if there is none
+ */
+const char* find_separator_utf8(const char* begin, const char* end);
+
+/**
+ * @brief Find the first '切', which starts every Chieru word, in the utf-8 text
+ *          [begin, end)
+ *
+ * @return const char* Its first byte, or end if there is none
+ */
+const char* find_word_head_utf8(const char* begin, const char* end);
+
+/**
+ * @brief Encode bytes into the utf-8 form of Chieru glyphs, low nibble first
+ *
+ * @param dst Output, must have room for 6 * length bytes
+ */
+void encode_nibbles_utf8(const unsigned char* src, std::size_t length, char* dst);
+
+/**
+ * @brief Decode utf-8 Chieru glyphs back into bytes, two glyphs (six bytes) per
+ *          byte
+ *
+ * @param src Glyphs to decode
+ * @param length Count of bytes in src, must be a multiple of 6
+ * @param dst Output, must have room for length / 6 bytes
+ * @return std::size_t Offset of the first glyph that isn't valid, or length
+ *          when every glyph is valid
+ */
+std::size_t decode_nibbles_utf8(const char* src, std::size_t length, unsigned char* dst);
+
+}  // namespace chieru
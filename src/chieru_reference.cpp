@@ -0,0 +1,166 @@
+/**
+ * @file chieru_reference.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the reference translator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_reference.h"
+
+#include <QHash>
+#include <QTextCodec>
+
+namespace {
+
+const QString& symbols() {
+    static const QString symbols = QString::fromUtf16(
+        u"！￥…（）—【】、；：‘’“”《》，。？～｀＃＄％＾＆＊－＿＝＋［］｛｝＼｜＇＂＜＞／"
+    );
+    return symbols;
+}
+
+const QString& chieru_charactors() {
+    static const QString charactors = QString::fromUtf16(u"切卟叮咧哔唎啪啰啵嘭噜噼巴拉蹦铃");
+    return charactors;
+}
+
+const QHash<QChar, int>& dict() {
+    static const QHash<QChar, int> dict = []() {
+        QHash<QChar, int> dict;
+        for (int i = 0; i < 16; ++i) dict.insert(chieru_charactors()[i], i);
+        return dict;
+    }();
+    return dict;
+}
+
+QByteArray chieru2word(QString::const_iterator begin, QString::const_iterator end) {
+    QByteArray result;
+
+    // A chieru word must start with '切', and the next charactors must be in pairs
+    if ((end - begin) < 2 || !((end - begin) & 1) || *begin != QChar(u'切'))
+        return "{ERROR}";
+
+    for (auto itr = begin + 1; itr != end;) {
+        char32_t code;
+
+        auto dict_itr = dict().find(*itr);
+        if (dict_itr == dict().end()) return "{ERROR}";
+        code = dict_itr.value();
+        ++itr;
+
+        dict_itr = dict().find(*itr);
+        if (dict_itr == dict().end()) return "{ERROR}";
+        code |= dict_itr.value() << 4;
+        ++itr;
+
+        result.push_back(code);
+    }
+
+    return result;
+}
+
+}  // namespace
+
+bool ChieruReference::is_separator(QChar ch) {
+    if ((ch < 0x30) ||                      // before '0'
+        (ch > 0x39 && ch <= 0x40) ||        // between '9' and 'A'
+        (ch > 0x5A && ch <= 0x60) ||        // between 'Z' and 'a'
+        (ch > 0x7A && ch <= 0x7F))          // after 'z' in ascii
+        return true;
+
+    // is Chinese symbol
+    for (QChar symbol : symbols())
+        if (ch == symbol) return true;
+
+    return false;
+}
+
+QString ChieruReference::word2chieru(const QByteArray& word) {
+    QString result = QString::fromUtf16(u"切");
+    result.reserve(word.size() * 2 + 2);
+
+    for (char ch : word) {
+        result.push_back(chieru_charactors()[ch & 15]);
+        result.push_back(chieru_charactors()[(ch & 0xF0) >> 4]);
+    }
+
+    return result;
+}
+
+QByteArray ChieruReference::chieru2word(const QString& word) {
+    return ::chieru2word(word.begin(), word.end());
+}
+
+QString ChieruReference::toChieru(const QString& string, QTextCodec* codec) {
+    QString result = QString::fromUtf16(u"切噜～♪");
+
+    int i = 0, s = 0;
+    for (int _end = string.length(); i < _end; ++i) {
+        if (is_separator(string[i])) {
+            if (s != i) {
+                result.append(word2chieru(codec->fromUnicode(string.midRef(s, i - s))));
+                s = i;
+            }
+            ++s;
+            result.push_back(string[i]);
+        }
+    }
+
+    if (s != string.length())
+        result.append(word2chieru(codec->fromUnicode(string.midRef(s, string.length() - s))));
+    return result;
+}
+
+bool ChieruReference::isChieru(const QString& string) {
+    return string.left(4) == QString::fromUtf16(u"切噜～♪");
+}
+
+QByteArray ChieruReference::fromChieruBytes(const QString& string, QTextCodec* codec) {
+    QByteArray result;
+    if (!isChieru(string)) return result;
+
+    int i = 4, s = 4, _end = string.length();
+    for (; i < _end; ++i) {
+        if (is_separator(string[i])) {
+            if (s != i) {
+                result.append(::chieru2word(string.begin() + s, string.begin() + i));
+                s = i;
+            }
+            ++s;
+            result.append(codec->fromUnicode(string.constData() + i, 1));
+        }
+    }
+
+    if (s != _end)
+        result.append(::chieru2word(string.begin() + s, string.end()));
+    return result;
+}
+
+QString ChieruReference::fromChieru(const QString& string, QTextCodec* codec) {
+    if (!isChieru(string))
+        return QString::fromUtf8("啥？ 你突然说什么啊……不敢相信，太差劲了……");
+
+    return codec->toUnicode(fromChieruBytes(string, codec));
+}
@@ -0,0 +1,64 @@
+/**
+ * @file chieru_reference.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief The first, plain implementation of the translator, kept as the
+ *          reference the fast paths are checked against
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+class QTextCodec;
+
+/**
+ * @brief ChieruTranslator as it was before any optimization: a hash lookup per
+ *          glyph, a linear search per separator and a codec call per word
+ *
+ * @warning Frozen on purpose. Don't optimize it or follow later changes of
+ *          the translator, except ones that change what the translation is.
+ *          Its only job is to say what the right answer is.
+ */
+class ChieruReference {
+ public:
+    static bool is_separator(QChar ch);
+
+    static QString word2chieru(const QByteArray& word);
+    // "{ERROR}" for malformed words
+    static QByteArray chieru2word(const QString& word);
+
+    static QString toChieru(const QString& string, QTextCodec* codec);
+    static QString fromChieru(const QString& string, QTextCodec* codec);
+
+    /**
+     * @brief fromChieru before the bytes are converted back by the codec,
+     *          empty for text that isn't Chieru
+     */
+    static QByteArray fromChieruBytes(const QString& string, QTextCodec* codec);
+
+    static bool isChieru(const QString& string);
+};
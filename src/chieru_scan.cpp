@@ -0,0 +1,142 @@
+/**
+ * @file chieru_scan.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the Chieru fragment scanner
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_scan.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "chieru_decode.h"
+#include "chieru_kernels.h"
+#include "chieru_utf8.h"
+
+namespace chieru {
+
+namespace {
+
+// Whether a word may start at word, right after a separator or the start
+bool at_word_start(const char* begin, const char* word, const char* end) {
+    if (word == begin) return true;
+
+    unsigned char before = static_cast<unsigned char>(word[-1]);
+    if (before < 0x80) return is_separator(before);
+    return word - begin >= 3 && utf8_separator_length(word - 3, end) == 3;
+}
+
+/**
+ * @brief Walk through the words and separators of [begin, end) in order, while
+ *          on_word returns true
+ */
+template <typename WordHandler, typename SeparatorHandler>
+void for_each_token(const char* begin, const char* end,
+                    WordHandler on_word, SeparatorHandler on_separator) {
+    for (const char* word = begin;; ) {
+        const char* separator = find_separator_utf8(word, end);
+        if (separator != word && !on_word(word, separator)) break;
+        if (separator == end) break;
+
+        const char* separator_end = separator + utf8_separator_length(separator, end);
+        on_separator(separator, separator_end);
+        word = separator_end;
+    }
+}
+
+}  // namespace
+
+bool find_fragment(std::string_view text, std::size_t from, const ScanOptions& options,
+                   Fragment& fragment) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    if (from >= text.size()) return false;
+
+    for (const char* head = begin + from;; head += kUtf8WordHead.size()) {
+        head = find_word_head_utf8(head, end);
+        if (head == end) return false;
+
+        bool has_header = text.substr(static_cast<std::size_t>(head - begin),
+                                      kUtf8Header.size()) == kUtf8Header;
+        if (!has_header && (!options.headerless || !at_word_start(begin, head, end))) continue;
+
+        // Take words while they are valid, the separators between them too
+        const char* body = has_header ? head + kUtf8Header.size() : head;
+        const char* run_end = body;
+        std::size_t words = 0;
+        for_each_token(body, end, [&](const char* word, const char* word_end) {
+            if (!decode_word_utf8(word, static_cast<std::size_t>(word_end - word), nullptr))
+                return false;
+            ++words;
+            run_end = word_end;
+            return true;
+        }, [](const char*, const char*) {});
+
+        // A header alone is more likely text about Chieru than Chieru
+        if (words < (has_header ? 1 : std::max<std::size_t>(options.min_words, 1))) continue;
+
+        fragment.begin = static_cast<std::size_t>(head - begin);
+        fragment.end = static_cast<std::size_t>(run_end - begin);
+        fragment.has_header = has_header;
+        fragment.words = words;
+        return true;
+    }
+}
+
+std::size_t decode_fragments_utf8(std::string_view text, char* dst, const ScanOptions& options,
+                                  std::size_t* fragments) {
+    // Output never gets ahead of input, so memmove takes care of dst being
+    // text.data(), and words decode behind their own glyphs
+    char* out = dst;
+    std::size_t position = 0;
+    std::size_t count = 0;
+
+    Fragment fragment;
+    while (find_fragment(text, position, options, fragment)) {
+        std::memmove(out, text.data() + position, fragment.begin - position);
+        out += fragment.begin - position;
+
+        const char* body = text.data() + fragment.begin +
+                           (fragment.has_header ? kUtf8Header.size() : 0);
+        for_each_token(body, text.data() + fragment.end, [&](const char* word, const char* word_end) {
+            out += decode_word_utf8(word, static_cast<std::size_t>(word_end - word),
+                                    reinterpret_cast<unsigned char*>(out)).length;
+            return true;
+        }, [&](const char* separator, const char* separator_end) {
+            std::memmove(out, separator, static_cast<std::size_t>(separator_end - separator));
+            out += separator_end - separator;
+        });
+
+        position = fragment.end;
+        ++count;
+    }
+
+    std::memmove(out, text.data() + position, text.size() - position);
+    out += text.size() - position;
+
+    if (fragments) *fragments = count;
+    return static_cast<std::size_t>(out - dst);
+}
+
+}  // namespace chieru
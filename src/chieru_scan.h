@@ -0,0 +1,83 @@
+/**
+ * @file chieru_scan.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Finding and decoding Chieru fragments inside ordinary utf-8 text
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace chieru {
+
+/**
+ * @brief What counts as a fragment of Chieru
+ */
+struct ScanOptions {
+    // Also take runs of words that lack the "切噜～♪" header
+    bool headerless = false;
+    // Words a run without header needs, as short words like "切啪啪" turn up
+    // in ordinary Chinese text as well
+    std::size_t min_words = 2;
+};
+
+/**
+ * @brief A run of valid Chieru words, and the separators between them
+ *
+ * Fragments start at a "切噜～♪" header, which may be anywhere, or with
+ * ScanOptions::headerless at a word right after a separator. They end with
+ * the last word before anything that isn't a valid word.
+ */
+struct Fragment {
+    std::size_t begin = 0;      // Offsets in bytes of the text
+    std::size_t end = 0;
+    bool has_header = false;
+    std::size_t words = 0;
+};
+
+/**
+ * @brief Find the first fragment starting at or after from
+ *
+ * @return bool Whether there is one
+ */
+bool find_fragment(std::string_view text, std::size_t from, const ScanOptions& options,
+                   Fragment& fragment);
+
+/**
+ * @brief Copy text to dst, decoding every fragment of Chieru in it and
+ *          passing everything else through untouched
+ *
+ * @param dst Output, must have room for text.size() bytes. May be text.data()
+ *          to decode in place, as fragments only ever shrink
+ * @param fragments Set to the count of fragments decoded, unless nullptr
+ * @return std::size_t Count of bytes written
+ */
+std::size_t decode_fragments_utf8(std::string_view text, char* dst,
+                                  const ScanOptions& options = ScanOptions(),
+                                  std::size_t* fragments = nullptr);
+
+}  // namespace chieru
@@ -0,0 +1,278 @@
+/**
+ * @file chieru_server.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the translation daemon
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_server.h"
+#include "chieru_translator.h"
+#include "chieru_utf8.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMap>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <limits>
+
+namespace {
+
+// Requests read ahead of their responses on one connection
+const int kMaxInFlight = 256;
+
+// Responses waiting for the client to read them, before requests are held back
+const qint64 kMaxPendingOutput = 16 * 1024 * 1024;
+
+// Larger requests (or lines still without a newline) close the connection, as
+// translating them takes about ten times their size in memory
+const int kMaxRequestSize = 16 * 1024 * 1024;
+
+// Larger http requests for the metrics are dropped
+const int kMaxMetricsRequestSize = 8 * 1024;
+
+QByteArray translate(char operation, const QByteArray& text) {
+    const QByteArray error(chieru::kUtf8Error.data(), static_cast<int>(chieru::kUtf8Error.size()));
+    if (operation != '1' && operation != '0') return error;
+
+    std::string_view view(text.constData(), static_cast<std::size_t>(text.size()));
+    std::size_t bound = operation == '1' ? chieru::to_chieru_utf8_bound(view.size())
+                                         : chieru::from_chieru_utf8_bound(view.size());
+    if (bound > static_cast<std::size_t>(std::numeric_limits<int>::max())) return error;
+
+    // Translated in one pass straight into the response, then cut down to what
+    // was written, so the slack isn't kept while the response waits its turn
+    QByteArray result(static_cast<int>(bound), Qt::Uninitialized);
+    std::size_t length = operation == '1' ? chieru::to_chieru_utf8(view, result.data())
+                                          : chieru::from_chieru_utf8(view, result.data());
+    result.resize(static_cast<int>(length));
+    result.squeeze();
+    return result;
+}
+
+}  // namespace
+
+/**
+ * @brief One client, living as a child of its socket
+ */
+class ChieruServer::Connection : public QObject {
+ public:
+    Connection(ChieruServer* server, QIODevice* socket)
+        : QObject(socket), m_server(server), m_socket(socket) {
+        connect(socket, &QIODevice::readyRead, this, &Connection::read);
+        connect(socket, &QIODevice::bytesWritten, this, &Connection::read);
+    }
+
+ private:
+    /**
+     * @brief Hand every complete request read so far to the workers, unless
+     *          the client falls too far behind
+     */
+    void read() {
+        // Unread requests stay with the socket, which pushes back on the client
+        if (isBusy()) return;
+        m_buffer.append(m_socket->readAll());
+
+        int position = 0;
+        while (!isBusy()) {
+            if (m_server->m_framing == LineFraming) {
+                // Bytes before m_scanned were searched for the newline already
+                int end = m_buffer.indexOf('\n', qMax(position, m_scanned));
+                if ((end < 0 ? m_buffer.size() : end) - position > kMaxRequestSize) {
+                    m_socket->close();
+                    return;
+                }
+                if (end < 0) {
+                    m_scanned = m_buffer.size();
+                    break;
+                }
+
+                int length = end - position;
+                if (length > 0 && m_buffer[end - 1] == '\r') --length;
+                QByteArray line = m_buffer.mid(position, length);
+                position = end + 1;
+
+                if (line.size() >= 2 && line[1] != ' ') line.clear();
+                submit(line.isEmpty() ? '\0' : line[0], line.mid(2));
+            } else {
+                if (m_buffer.size() - position < 4) break;
+                quint32 length = qFromBigEndian<quint32>(m_buffer.constData() + position);
+                if (length > static_cast<quint32>(kMaxRequestSize)) {
+                    m_socket->close();
+                    return;
+                }
+                if (static_cast<quint32>(m_buffer.size() - position - 4) < length) break;
+
+                QByteArray request = m_buffer.mid(position + 4, static_cast<int>(length));
+                position += 4 + static_cast<int>(length);
+                submit(request.isEmpty() ? '\0' : request[0], request.mid(1));
+            }
+        }
+        m_buffer.remove(0, position);
+        m_scanned = qMax(m_scanned - position, 0);
+    }
+
+    bool isBusy() const {
+        return m_in_flight >= kMaxInFlight || m_socket->bytesToWrite() >= kMaxPendingOutput;
+    }
+
+    void submit(char operation, const QByteArray& text) {
+        quint64 sequence = m_next_request++;
+        ++m_in_flight;
+        ++m_server->m_requests;
+
+        // The connection may be gone by the time the response is ready, so it is
+        // delivered through the server and only if the connection still exists
+        QPointer<Connection> self(this);
+        ChieruServer* server = m_server;
+        QtConcurrent::run(&server->m_pool, [server, self, sequence, operation, text]() {
+            QByteArray response = translate(operation, text);
+            QMetaObject::invokeMethod(server, [self, sequence, response]() {
+                if (self) self->deliver(sequence, response);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    /**
+     * @brief Write out the responses that are next in order
+     */
+    void deliver(quint64 sequence, const QByteArray& response) {
+        --m_in_flight;
+        m_ready.insert(sequence, response);
+
+        while (!m_ready.isEmpty() && m_ready.firstKey() == m_next_response) {
+            QByteArray ready = m_ready.take(m_next_response++);
+            if (m_server->m_framing == LineFraming) {
+                ready.append('\n');
+            } else {
+                char length[4];
+                qToBigEndian<quint32>(static_cast<quint32>(ready.size()), length);
+                m_socket->write(length, 4);
+            }
+            m_socket->write(ready);
+        }
+
+        // Requests may have been held back
+        read();
+    }
+
+    ChieruServer* m_server;
+    QIODevice* m_socket;
+    QByteArray m_buffer;
+    int m_scanned = 0;
+
+    quint64 m_next_request = 0;
+    quint64 m_next_response = 0;
+    int m_in_flight = 0;
+    QMap<quint64, QByteArray> m_ready;
+};
+
+ChieruServer::ChieruServer(Framing framing, int threads, QObject* parent)
+    : QObject(parent),
+      m_framing(framing),
+      m_local_server(nullptr),
+      m_tcp_server(nullptr),
+      m_metrics_server(nullptr),
+      m_requests(0) {
+    if (threads > 0) m_pool.setMaxThreadCount(threads);
+}
+
+ChieruServer::~ChieruServer() {
+    // Workers post their responses to this server
+    m_pool.waitForDone();
+}
+
+bool ChieruServer::listenLocal(const QString& name) {
+    m_local_server = new QLocalServer(this);
+    connect(m_local_server, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket* socket = m_local_server->nextPendingConnection()) {
+            connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            accept(socket);
+        }
+    });
+
+    QLocalServer::removeServer(name);
+    if (m_local_server->listen(name)) return true;
+    m_error = m_local_server->errorString();
+    return false;
+}
+
+bool ChieruServer::listenTcp(quint16 port) {
+    m_tcp_server = new QTcpServer(this);
+    connect(m_tcp_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket* socket = m_tcp_server->nextPendingConnection()) {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            accept(socket);
+        }
+    });
+
+    if (m_tcp_server->listen(QHostAddress::LocalHost, port)) return true;
+    m_error = m_tcp_server->errorString();
+    return false;
+}
+
+void ChieruServer::accept(QIODevice* socket) {
+    new Connection(this, socket);
+}
+
+bool ChieruServer::listenMetrics(quint16 port) {
+    m_metrics_server = new QTcpServer(this);
+    connect(m_metrics_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket* socket = m_metrics_server->nextPendingConnection()) {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                serveMetrics(socket);
+            });
+        }
+    });
+
+    if (m_metrics_server->listen(QHostAddress::LocalHost, port)) return true;
+    m_error = m_metrics_server->errorString();
+    return false;
+}
+
+void ChieruServer::serveMetrics(QTcpSocket* socket) {
+    // Whatever was asked for, the answer is the same once the headers are in
+    QByteArray request = socket->peek(kMaxMetricsRequestSize);
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+        if (request.size() >= kMaxMetricsRequestSize) socket->abort();
+        return;
+    }
+    socket->readAll();
+
+    std::string body = chieru::stats_prometheus(ChieruTranslator::stats());
+    body += "# TYPE chieru_server_requests_total counter\n";
+    body += "chieru_server_requests_total " + std::to_string(m_requests) + "\n";
+
+    QByteArray response = "HTTP/1.0 200 OK\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: " + QByteArray::number(static_cast<qulonglong>(body.size())) +
+                          "\r\nConnection: close\r\n\r\n";
+    response.append(body.data(), static_cast<int>(body.size()));
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,106 @@
+/**
+ * @file chieru_server.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Translation daemon serving local clients
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @brief Serves translation requests over a local socket or a localhost tcp
+ *          port, from a pool of worker threads
+ *
+ * Requests on a connection are pipelined: every complete request is handed to
+ * the workers as soon as it is read, and responses are written back in the
+ * order of the requests as they complete.
+ *
+ * Line framing: "1 <text>\n" asks for text in Chieru, "0 <text>\n" for Chieru
+ * text back, answered by "<result>\n". Neither side may contain newlines, so
+ * decoding arbitrary bytes needs length framing.
+ *
+ * Length framing: a 32-bit big-endian length, then '1' or '0' and the text,
+ * answered by a 32-bit big-endian length and the result.
+ *
+ * All texts are utf-8, requests that can't be understood get "{ERROR}".
+ * Requests over 16 MB close the connection.
+ *
+ * Statistics of the translator are served separately over http, in the
+ * Prometheus text format, see listenMetrics().
+ */
+class ChieruServer : public QObject {
+    Q_OBJECT
+
+ public:
+    enum Framing {
+        LineFraming,
+        LengthFraming
+    };
+
+    /**
+     * @param threads Count of worker threads, 0 for one per core
+     */
+    explicit ChieruServer(Framing framing, int threads = 0, QObject* parent = nullptr);
+    ~ChieruServer() override;
+
+    /**
+     * @brief Listen on a local socket (a unix domain socket, or a named pipe on
+     *          Windows), replacing a stale one of the same name
+     */
+    bool listenLocal(const QString& name);
+
+    /**
+     * @brief Listen on a tcp port of localhost
+     */
+    bool listenTcp(quint16 port);
+
+    /**
+     * @brief Answer every http request on a tcp port of localhost with the
+     *          statistics of the translator, for Prometheus to scrape
+     */
+    bool listenMetrics(quint16 port);
+
+    QString errorString() const { return m_error; }
+
+ private:
+    class Connection;
+
+    void accept(QIODevice* socket);
+    void serveMetrics(QTcpSocket* socket);
+
+    Framing m_framing;
+    QThreadPool m_pool;
+    QLocalServer* m_local_server;
+    QTcpServer* m_tcp_server;
+    QTcpServer* m_metrics_server;
+    QString m_error;
+    quint64 m_requests;
+};
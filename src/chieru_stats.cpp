@@ -0,0 +1,242 @@
+/**
+ * @file chieru_stats.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of translation statistics
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_stats.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#ifdef CHIERU_STATS
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace chieru {
+
+namespace {
+
+const char* const kPhaseNames[kStatPhaseCount] = {
+    "separators", "codec", "encode", "decode", "append"
+};
+
+const char* const kCounterNames[kStatCounterCount] = {
+    "encoded_words", "encoded_bytes", "decoded_words", "decoded_bytes", "separators",
+    "allocations", "not_chieru", "bad_prefix", "odd_length", "unknown_glyph"
+};
+
+// Counters of errors are dumped as one metric labelled by kind
+constexpr int kFirstError = static_cast<int>(StatCounter::NotChieru);
+static_assert(kFirstError + static_cast<int>(DecodeError::UnknownGlyph) - 1 ==
+                  static_cast<int>(StatCounter::UnknownGlyph),
+              "error counters must follow DecodeError");
+
+#ifdef CHIERU_STATS
+
+/**
+ * @brief Statistics of one thread. Only that thread writes them, so plain
+ *          loads and stores do, and other threads read them for snapshots.
+ */
+struct StatBlock {
+    std::atomic<uint64_t> counters[kStatCounterCount] = {};
+    std::atomic<uint64_t> phase_calls[kStatPhaseCount] = {};
+    std::atomic<uint64_t> phase_nanoseconds[kStatPhaseCount] = {};
+    unsigned sample_ticks[kStatPhaseCount] = {};
+};
+
+void bump(std::atomic<uint64_t>& value, uint64_t count) {
+    value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+void add_to(StatsSnapshot& snapshot, const StatBlock& block) {
+    for (int i = 0; i < kStatCounterCount; ++i)
+        snapshot.counters[i] += block.counters[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < kStatPhaseCount; ++i) {
+        snapshot.phase_calls[i] += block.phase_calls[i].load(std::memory_order_relaxed);
+        snapshot.phase_nanoseconds[i] += block.phase_nanoseconds[i].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Blocks of the running threads, plus what finished threads left and
+ *          the totals at the last reset
+ */
+struct StatRegistry {
+    std::mutex mutex;
+    std::vector<StatBlock*> blocks;
+    StatsSnapshot retired;
+    StatsSnapshot baseline;
+
+    static StatRegistry& instance() {
+        // Leaked, threads may still exit after static destruction
+        static StatRegistry* registry = new StatRegistry;
+        return *registry;
+    }
+
+    StatsSnapshot total() {
+        StatsSnapshot snapshot = retired;
+        for (const StatBlock* block : blocks) add_to(snapshot, *block);
+        return snapshot;
+    }
+};
+
+struct LocalBlock {
+    StatBlock block;
+
+    LocalBlock() {
+        StatRegistry& registry = StatRegistry::instance();
+        std::lock_guard<std::mutex> locker(registry.mutex);
+        registry.blocks.push_back(&block);
+    }
+
+    ~LocalBlock() {
+        StatRegistry& registry = StatRegistry::instance();
+        std::lock_guard<std::mutex> locker(registry.mutex);
+        add_to(registry.retired, block);
+        registry.blocks.erase(std::find(registry.blocks.begin(), registry.blocks.end(), &block));
+    }
+};
+
+StatBlock& local_block() {
+    thread_local LocalBlock local;
+    return local.block;
+}
+
+int64_t now_nanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
+
+}  // namespace
+
+const char* stat_phase_name(StatPhase phase) {
+    return kPhaseNames[static_cast<int>(phase)];
+}
+
+const char* stat_counter_name(StatCounter counter) {
+    return kCounterNames[static_cast<int>(counter)];
+}
+
+#ifdef CHIERU_STATS
+
+StatsSnapshot stats_snapshot() {
+    StatRegistry& registry = StatRegistry::instance();
+    std::lock_guard<std::mutex> locker(registry.mutex);
+
+    StatsSnapshot snapshot = registry.total();
+    const StatsSnapshot& baseline = registry.baseline;
+    for (int i = 0; i < kStatCounterCount; ++i) snapshot.counters[i] -= baseline.counters[i];
+    for (int i = 0; i < kStatPhaseCount; ++i) {
+        snapshot.phase_calls[i] -= baseline.phase_calls[i];
+        snapshot.phase_nanoseconds[i] -= baseline.phase_nanoseconds[i];
+    }
+    snapshot.enabled = true;
+    return snapshot;
+}
+
+void reset_stats() {
+    // Blocks belong to their threads, so they are left alone and the totals
+    // so far are subtracted from later snapshots instead
+    StatRegistry& registry = StatRegistry::instance();
+    std::lock_guard<std::mutex> locker(registry.mutex);
+    registry.baseline = registry.total();
+}
+
+void stat_add(StatCounter counter, uint64_t count) {
+    bump(local_block().counters[static_cast<int>(counter)], count);
+}
+
+void stat_error(DecodeError error) {
+    if (error == DecodeError::None) return;
+    stat_add(static_cast<StatCounter>(kFirstError + static_cast<int>(error) - 1), 1);
+}
+
+PhaseTimer::PhaseTimer(StatPhase phase) : m_phase(phase), m_start(-1) {
+    StatBlock& block = local_block();
+    int index = static_cast<int>(phase);
+    bump(block.phase_calls[index], 1);
+    if (block.sample_ticks[index]++ % kStatSampleRate == 0) m_start = now_nanoseconds();
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (m_start < 0) return;
+    uint64_t elapsed = static_cast<uint64_t>(now_nanoseconds() - m_start);
+    bump(local_block().phase_nanoseconds[static_cast<int>(m_phase)], elapsed * kStatSampleRate);
+}
+
+#else
+
+StatsSnapshot stats_snapshot() {
+    return StatsSnapshot();
+}
+
+void reset_stats() {}
+
+#endif
+
+std::string stats_prometheus(const StatsSnapshot& snapshot, const char* prefix) {
+    std::string text;
+    char line[256];
+    auto append = [&](const char* format, auto... args) {
+        std::snprintf(line, sizeof(line), format, args...);
+        text += line;
+    };
+
+    append("# HELP %s_stats_enabled Whether the translator was built with CHIERU_STATS.\n", prefix);
+    append("# TYPE %s_stats_enabled gauge\n", prefix);
+    append("%s_stats_enabled %d\n", prefix, snapshot.enabled ? 1 : 0);
+
+    for (int i = 0; i < kFirstError; ++i) {
+        append("# TYPE %s_%s_total counter\n", prefix, kCounterNames[i]);
+        append("%s_%s_total %" PRIu64 "\n", prefix, kCounterNames[i], snapshot.counters[i]);
+    }
+
+    append("# HELP %s_decode_errors_total Malformed input met while decoding, by kind.\n", prefix);
+    append("# TYPE %s_decode_errors_total counter\n", prefix);
+    for (int i = kFirstError; i < kStatCounterCount; ++i)
+        append("%s_decode_errors_total{kind=\"%s\"} %" PRIu64 "\n", prefix, kCounterNames[i],
+               snapshot.counters[i]);
+
+    append("# TYPE %s_phase_calls_total counter\n", prefix);
+    for (int i = 0; i < kStatPhaseCount; ++i)
+        append("%s_phase_calls_total{phase=\"%s\"} %" PRIu64 "\n", prefix, kPhaseNames[i],
+               snapshot.phase_calls[i]);
+
+    append("# HELP %s_phase_seconds_total Time spent in every phase, estimated by sampling.\n",
+           prefix);
+    append("# TYPE %s_phase_seconds_total counter\n", prefix);
+    for (int i = 0; i < kStatPhaseCount; ++i)
+        append("%s_phase_seconds_total{phase=\"%s\"} %.9f\n", prefix, kPhaseNames[i],
+               snapshot.phase_nanoseconds[i] / 1e9);
+    return text;
+}
+
+}  // namespace chieru
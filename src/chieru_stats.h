@@ -0,0 +1,154 @@
+/**
+ * @file chieru_stats.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Optional counters and timers on the hot paths of translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "chieru_decode.h"
+
+/**
+ * Statistics are only collected when built with CHIERU_STATS defined
+ * ("qmake CONFIG+=chieru_stats"). Otherwise the macros below are empty, and
+ * snapshots are all zero.
+ */
+
+namespace chieru {
+
+/**
+ * @brief Parts of translation that are timed
+ */
+enum class StatPhase {
+    Separators,     // Finding the separators between words
+    Codec,          // Converting between text and bytes of the codec
+    Encode,         // Turning bytes into glyphs
+    Decode,         // Turning glyphs back into bytes
+    Append,         // Copying translations into place
+    Count
+};
+
+/**
+ * @brief Things that are counted
+ */
+enum class StatCounter {
+    EncodedWords,
+    EncodedBytes,       // Bytes turned into glyphs
+    DecodedWords,
+    DecodedBytes,       // Bytes glyphs were turned back into
+    Separators,
+    Allocations,        // Buffers allocated by the translator
+    NotChieru,          // Errors, by DecodeError
+    BadPrefix,
+    OddLength,
+    UnknownGlyph,
+    Count
+};
+
+constexpr int kStatPhaseCount = static_cast<int>(StatPhase::Count);
+constexpr int kStatCounterCount = static_cast<int>(StatCounter::Count);
+
+/**
+ * @brief Snake case names, like "separators" or "encoded_words"
+ */
+const char* stat_phase_name(StatPhase phase);
+const char* stat_counter_name(StatCounter counter);
+
+/**
+ * @brief Totals of every thread since the last reset_stats()
+ */
+struct StatsSnapshot {
+    bool enabled = false;
+    uint64_t counters[kStatCounterCount] = {};
+    uint64_t phase_calls[kStatPhaseCount] = {};
+    // Estimated from one call in kStatSampleRate, as reading the clock on
+    // every call would cost more than some of the phases
+    uint64_t phase_nanoseconds[kStatPhaseCount] = {};
+
+    uint64_t counter(StatCounter counter) const {
+        return counters[static_cast<int>(counter)];
+    }
+    uint64_t calls(StatPhase phase) const {
+        return phase_calls[static_cast<int>(phase)];
+    }
+    uint64_t nanoseconds(StatPhase phase) const {
+        return phase_nanoseconds[static_cast<int>(phase)];
+    }
+};
+
+constexpr unsigned kStatSampleRate = 64;
+
+StatsSnapshot stats_snapshot();
+void reset_stats();
+
+/**
+ * @brief The snapshot in the Prometheus text format, every metric named
+ *          prefix_...
+ */
+std::string stats_prometheus(const StatsSnapshot& snapshot, const char* prefix = "chieru");
+
+#ifdef CHIERU_STATS
+
+void stat_add(StatCounter counter, uint64_t count);
+void stat_error(DecodeError error);
+
+/**
+ * @brief Counts a call to a phase, and times it if it is sampled
+ */
+class PhaseTimer {
+ public:
+    explicit PhaseTimer(StatPhase phase);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+ private:
+    StatPhase m_phase;
+    int64_t m_start;    // Negative when not sampled
+};
+
+#define CHIERU_STAT_CONCAT_(a, b) a##b
+#define CHIERU_STAT_CONCAT(a, b) CHIERU_STAT_CONCAT_(a, b)
+
+#define CHIERU_STAT_ADD(counter, count) \
+    ::chieru::stat_add(::chieru::StatCounter::counter, (count))
+#define CHIERU_STAT_ERROR(error) ::chieru::stat_error(error)
+// Times the rest of the enclosing scope
+#define CHIERU_STAT_PHASE(phase) \
+    ::chieru::PhaseTimer CHIERU_STAT_CONCAT(chieru_phase_timer_, __LINE__)(::chieru::StatPhase::phase)
+
+#else
+
+#define CHIERU_STAT_ADD(counter, count) ((void)0)
+#define CHIERU_STAT_ERROR(error) ((void)0)
+#define CHIERU_STAT_PHASE(phase) ((void)0)
+
+#endif
+
+}  // namespace chieru
@@ -0,0 +1,214 @@
+/**
+ * @file chieru_stream.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the stream translator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_stream.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "chieru_kernels.h"
+#include "chieru_utf8.h"
+
+namespace {
+
+// Count of bytes at the end of [begin, end) that may be the start of a
+// separator that the next chunk completes
+std::size_t separator_tail(const char* begin, const char* end) {
+    auto is_lead = [](char ch) {
+        unsigned char byte = static_cast<unsigned char>(ch);
+        return byte == 0xE2 || byte == 0xE3 || byte == 0xEF;
+    };
+
+    if (end - begin >= 1 && is_lead(end[-1])) return 1;
+    if (end - begin >= 2 && is_lead(end[-2]) && (static_cast<unsigned char>(end[-1]) & 0xC0) == 0x80)
+        return 2;
+    return 0;
+}
+
+}  // namespace
+
+ChieruStreamTranslator::ChieruStreamTranslator(Direction direction)
+    : m_direction(direction)
+    , m_state(direction == FromChieru ? Header : Body)
+    , m_in_word(false)
+    , m_word_valid(true)
+    , m_word_head(0) {
+    if (direction == ToChieru) m_output.append(chieru::kUtf8Header);
+}
+
+void ChieruStreamTranslator::push(const char* data, std::size_t length) {
+    if (m_state == Rejected) return;
+
+    const char* begin = data;
+    const char* end = data + length;
+    if (!m_held.empty()) {
+        m_input.assign(m_held);
+        m_input.append(data, length);
+        m_held.clear();
+        begin = m_input.data();
+        end = begin + m_input.size();
+    }
+
+    if (m_state == Header) {
+        std::string_view received(begin, static_cast<std::size_t>(end - begin));
+        if (received.substr(0, chieru::kUtf8Header.size()) !=
+            chieru::kUtf8Header.substr(0, received.size())) {
+            m_output.append(chieru::kUtf8NotChieru);
+            m_state = Rejected;
+            return;
+        }
+        if (received.size() < chieru::kUtf8Header.size()) {
+            m_held.assign(begin, end);
+            return;
+        }
+
+        begin += chieru::kUtf8Header.size();
+        m_state = Body;
+    }
+
+    const char* body_end = end - separator_tail(begin, end);
+    m_held.assign(body_end, end);
+    translateBody(begin, body_end);
+}
+
+void ChieruStreamTranslator::finish() {
+    if (m_state == Rejected) return;
+    if (m_state == Header) {
+        // The text is shorter than the header
+        m_output.append(chieru::kUtf8NotChieru);
+        m_state = Rejected;
+        return;
+    }
+
+    std::string held;
+    held.swap(m_held);
+    translateBody(held.data(), held.data() + held.size());
+    endWord();
+}
+
+void ChieruStreamTranslator::translateBody(const char* begin, const char* end) {
+    for (const char* word = begin;; ) {
+        const char* separator = chieru::find_separator_utf8(word, end);
+        if (separator != word) {
+            if (m_direction == ToChieru)
+                encodeWord(word, separator);
+            else
+                decodeWord(word, separator);
+            m_in_word = true;
+        }
+        if (separator == end) break;
+
+        endWord();
+        const char* separator_end = separator + chieru::utf8_separator_length(separator, end);
+        m_output.append(separator, separator_end);
+        word = separator_end;
+    }
+}
+
+void ChieruStreamTranslator::encodeWord(const char* begin, const char* end) {
+    if (!m_in_word) m_output.append(chieru::kUtf8WordHead);
+
+    std::size_t old_size = m_output.size();
+    std::size_t length = static_cast<std::size_t>(end - begin);
+    m_output.resize(old_size + length * 6);
+    chieru::encode_nibbles_utf8(reinterpret_cast<const unsigned char*>(begin), length,
+                                &m_output[old_size]);
+}
+
+void ChieruStreamTranslator::decodeWord(const char* begin, const char* end) {
+    if (!m_word_valid) return;
+
+    auto decode = [this](const char* glyphs, std::size_t length) {
+        std::size_t old_size = m_word.size();
+        m_word.resize(old_size + length / 6);
+        if (chieru::decode_nibbles_utf8(glyphs, length,
+                reinterpret_cast<unsigned char*>(&m_word[old_size])) != length) {
+            m_word_valid = false;
+            m_word.clear();
+        }
+        return m_word_valid;
+    };
+
+    // A word must start with '切', and the next glyphs must be in pairs
+    for (; m_word_head < chieru::kUtf8WordHead.size() && begin != end; ++m_word_head, ++begin) {
+        if (*begin != chieru::kUtf8WordHead[m_word_head]) {
+            m_word_valid = false;
+            return;
+        }
+    }
+
+    // Finish the pair left incomplete by the last chunk
+    if (!m_word_glyphs.empty()) {
+        std::size_t taken = std::min<std::size_t>(6 - m_word_glyphs.size(),
+                                                  static_cast<std::size_t>(end - begin));
+        m_word_glyphs.append(begin, taken);
+        begin += taken;
+        if (m_word_glyphs.size() < 6) return;
+        if (!decode(m_word_glyphs.data(), 6)) return;
+        m_word_glyphs.clear();
+    }
+
+    std::size_t pairs = static_cast<std::size_t>(end - begin) / 6 * 6;
+    if (!decode(begin, pairs)) return;
+    m_word_glyphs.assign(begin + pairs, end);
+}
+
+void ChieruStreamTranslator::endWord() {
+    if (!m_in_word) return;
+    m_in_word = false;
+    if (m_direction == ToChieru) return;
+
+    if (m_word_valid && m_word_head == chieru::kUtf8WordHead.size() &&
+        m_word_glyphs.empty() && !m_word.empty())
+        m_output.append(m_word);
+    else
+        m_output.append(chieru::kUtf8Error);
+
+    m_word_valid = true;
+    m_word_head = 0;
+    m_word_glyphs.clear();
+    m_word.clear();
+}
+
+bool ChieruStreamTranslator::translate(std::istream& input, std::ostream& output,
+                                       Direction direction, std::size_t chunk_size) {
+    ChieruStreamTranslator translator(direction);
+    std::vector<char> chunk(chunk_size);
+
+    while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || input.gcount()) {
+        translator.push(chunk.data(), static_cast<std::size_t>(input.gcount()));
+        output.write(translator.output().data(),
+                     static_cast<std::streamsize>(translator.output().size()));
+        translator.consume();
+    }
+    translator.finish();
+    output.write(translator.output().data(), static_cast<std::streamsize>(translator.output().size()));
+
+    return static_cast<bool>(output);
+}
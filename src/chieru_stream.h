@@ -0,0 +1,105 @@
+/**
+ * @file chieru_stream.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Chunked utf-8 translation with bounded memory
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+/**
+ * @brief Translates utf-8 text pushed in chunks of any size, producing the same
+ *          bytes as ChieruTranslator::toChieruUtf8 and fromChieruUtf8 would for
+ *          the whole text
+ *
+ * Multi-byte charactors, words and the "切噜～♪" header may be split anywhere
+ * between chunks. Memory stays proportional to the chunk size, except that
+ * decoding holds the decoded bytes of the current word until it ends.
+ *
+ * The output of each push is collected in output(); call consume() once it is
+ * written out to keep the buffer from growing.
+ */
+class ChieruStreamTranslator {
+ public:
+    enum Direction {
+        ToChieru,
+        FromChieru
+    };
+
+    explicit ChieruStreamTranslator(Direction direction);
+
+    /**
+     * @brief Translate the next chunk of input
+     */
+    void push(const char* data, std::size_t length);
+
+    /**
+     * @brief Flush everything held back for the next chunk, after the last one
+     */
+    void finish();
+
+    const std::string& output() const { return m_output; }
+    void consume() { m_output.clear(); }
+
+    /**
+     * @brief Translate everything from input to output chunk by chunk
+     *
+     * @return bool Whether all the output was written
+     */
+    static bool translate(std::istream& input, std::ostream& output, Direction direction,
+                          std::size_t chunk_size = 64 * 1024);
+
+ private:
+    enum State {
+        Header,     // Decoding, the header isn't complete yet
+        Body,
+        Rejected    // Decoding, the header was wrong so the rest is ignored
+    };
+
+    void translateBody(const char* begin, const char* end);
+    void encodeWord(const char* begin, const char* end);
+    void decodeWord(const char* begin, const char* end);
+    void endWord();
+
+    Direction m_direction;
+    State m_state;
+
+    // Bytes at the end of the last chunk that may start a separator, or the
+    // incomplete header
+    std::string m_held;
+    std::string m_input;
+
+    bool m_in_word;
+
+    // Decoding of the current word
+    bool m_word_valid;
+    std::size_t m_word_head;    // Bytes of '切' matched so far
+    std::string m_word_glyphs;  // Glyph bytes short of a full pair
+    std::string m_word;         // Decoded bytes
+
+    std::string m_output;
+};
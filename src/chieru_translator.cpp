@@ -26,82 +26,593 @@
  * THE SOFTWARE.
  */
 #include "chieru_translator.h"
-#include <QMutex>
+#include "chieru_stats.h"
+#include "chieru_stream.h"
+#include "chieru_utf16.h"
+#include "chieru_utf8.h"
+#include "chieru_word_cache.h"
+#include "codec_layout.h"
+#include "singleton.h"
 #include <QDebug>
+#include <QIODevice>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
 
-bool ChieruTranslator::s_initialized = false;
-QChar ChieruTranslator::s_chieru_charactor[16];
-QHash<QChar, int> ChieruTranslator::s_dict;
-QString ChieruTranslator::s_symbols = QString::fromUtf16(
-    u"！￥…（）—【】、；：‘’“”《》，。？～｀＃＄％＾＆＊－＿＝＋［］｛｝＼｜＇＂＜＞／"
-);
+#include <algorithm>
 
-ChieruTranslator::ChieruTranslator() {
-    initialize();
+namespace {
+
+const int kUtf8Mib = 106;
+
+const char16_t kHeader[] = u"切噜～♪";
+const int kHeaderLength = 4;
+
+/**
+ * @brief The codec to use, utf-8 for nullptr, looked up only once
+ */
+QTextCodec* resolve_codec(QTextCodec* codec) {
+    if (codec) return codec;
+    static QTextCodec* utf8 = QTextCodec::codecForMib(kUtf8Mib);
+    return utf8;
+}
+
+bool is_utf8(const QTextCodec* codec) {
+    return codec->mibEnum() == kUtf8Mib;
+}
+
+std::u16string_view view(const QChar* begin, const QChar* end) {
+    return std::u16string_view(reinterpret_cast<const char16_t*>(begin),
+                               static_cast<std::size_t>(end - begin));
+}
+
+int utf8_length(const QChar* begin, const QChar* end) {
+    return static_cast<int>(chieru::utf8_length(reinterpret_cast<const char16_t*>(begin),
+                                                static_cast<std::size_t>(end - begin)));
+}
+
+int encode_utf8(const QChar* begin, const QChar* end, char* dst) {
+    return static_cast<int>(chieru::encode_utf8(reinterpret_cast<const char16_t*>(begin),
+                                                static_cast<std::size_t>(end - begin),
+                                                reinterpret_cast<unsigned char*>(dst)));
+}
+
+// Size of the decoded word, exact when the word is valid
+int decoded_length(int word_length) {
+    if (word_length < 2 || !(word_length & 1)) return 7;  // "{ERROR}"
+    return word_length / 2;
+}
+
+/**
+ * @brief Walk through the words and separators of [begin, end) in order
+ *
+ * @param on_word Called with (begin, end) of every word
+ * @param on_separator Called with every separator
+ */
+template <typename WordHandler, typename SeparatorHandler>
+void for_each_token(const QChar* begin, const QChar* end,
+                    WordHandler on_word, SeparatorHandler on_separator) {
+    for (const QChar* word = begin;; ) {
+        const QChar* separator;
+        {
+            CHIERU_STAT_PHASE(Separators);
+            separator = reinterpret_cast<const QChar*>(
+                chieru::find_separator(reinterpret_cast<const char16_t*>(word),
+                                       reinterpret_cast<const char16_t*>(end)));
+        }
+        if (separator != word) on_word(word, separator);
+        if (separator == end) break;
+
+        on_separator(*separator);
+        word = separator + 1;
+    }
+}
+
+/**
+ * @brief Write '切' and the glyphs of the bytes to dst, which must have room
+ *          for 1 + 2 * length charactors
+ *
+ * @return QChar* The end of what is written
+ */
+QChar* write_word(QChar* dst, const char* bytes, int length) {
+    CHIERU_STAT_PHASE(Encode);
+    CHIERU_STAT_ADD(EncodedWords, 1);
+    CHIERU_STAT_ADD(EncodedBytes, length);
+    *dst = QChar(chieru::kGlyphs[0]);  // '切'
+    chieru::encode_nibbles(reinterpret_cast<const unsigned char*>(bytes), length,
+                           reinterpret_cast<char16_t*>(dst + 1));
+    return dst + 1 + length * 2;
 }
 
-void ChieruTranslator::initialize() {
-    static QMutex initialize_mutex;
-    if (s_initialized) return;
+/**
+ * @brief Decode a chieru word onto the end of result, "{ERROR}" if malformed
+ */
+void append_word(QByteArray& result, const QChar* begin, const QChar* end) {
+    CHIERU_STAT_PHASE(Decode);
+    CHIERU_STAT_ADD(DecodedWords, 1);
 
-    initialize_mutex.lock();
-    if (s_initialized) return;
+    // A chieru word must start with '切', and the next charactors must be in pairs
+    bool headed = begin != end && *begin == QChar(chieru::kGlyphs[0]);
+    if (!headed || (end - begin) < 2 || !((end - begin) & 1)) {
+        CHIERU_STAT_ERROR(headed ? chieru::DecodeError::OddLength
+                                 : chieru::DecodeError::BadPrefix);
+        result.append("{ERROR}");
+        return;
+    }
 
-    QString chieru_dict = QString::fromUtf16(u"切卟叮咧哔唎啪啰啵嘭噜噼巴拉蹦铃");
-    assert(chieru_dict.length() == 16);
+    int length = static_cast<int>(end - begin) - 1;
+    int old_size = result.size();
+    result.resize(old_size + length / 2);
 
-    for (int i = 0; i < 16; ++i) {
-        s_chieru_charactor[i] = chieru_dict[i];
-        s_dict.insert(chieru_dict[i], i);
+    std::size_t decoded = chieru::decode_nibbles(
+        reinterpret_cast<const char16_t*>(begin + 1), length,
+        reinterpret_cast<unsigned char*>(result.data() + old_size));
+    if (decoded != static_cast<std::size_t>(length)) {
+        CHIERU_STAT_ERROR(chieru::DecodeError::UnknownGlyph);
+        result.resize(old_size);
+        result.append("{ERROR}");
+        return;
     }
+    CHIERU_STAT_ADD(DecodedBytes, length / 2);
+}
 
-    s_initialized = true;
+/**
+ * @brief Buffers every thread keeps from one translation to the next, so that
+ *          pieces and words don't allocate their own
+ */
+struct Scratch {
+    QByteArray word_bytes;  // A word in bytes of the codec
+    QString separators;     // Separators of a piece, in order
+};
 
-    initialize_mutex.unlock();
+Scratch* scratch() {
+    return ThreadInstance<Scratch>();
 }
 
-QString ChieruTranslator::word2chieru(QByteArray::const_iterator begin,
-                                      QByteArray::const_iterator end) {
-    QString result = QString::fromUtf16(u"切");
-    assert(result.length() == 1);
-    result.reserve((end - begin) * 2 + 2);
+// Scratch buffers grown past this many elements are given back after use, so
+// that one huge word doesn't keep its size pinned on every thread for good
+const int kMaxScratchCapacity = 64 * 1024;
+
+/**
+ * @brief Give back a scratch buffer that grew past kMaxScratchCapacity
+ */
+template <typename Buffer>
+void trim_scratch(Buffer& buffer) {
+    if (buffer.capacity() > kMaxScratchCapacity) buffer = Buffer();
+}
+
+/**
+ * @brief Make room for length bytes in the scratch buffer for words
+ */
+char* reserve_word_bytes(int length) {
+    QByteArray& bytes = scratch()->word_bytes;
+    if (bytes.size() < length) {
+        bytes.resize(length);
+        CHIERU_STAT_ADD(Allocations, 1);
+    }
+    return bytes.data();
+}
+
+/**
+ * @brief A piece of the text to be translated into Chieru. Pieces are sized
+ *          first, then written straight into their place in the result.
+ */
+struct EncodePiece {
+    enum Method {
+        Utf8,       // Translated by the Qt-free core
+        Whole,      // The piece converted at once by a stateless codec
+        WordByWord  // Every word converted by the codec, translated up front
+    };
+
+    const QChar* begin;
+    const QChar* end;
+    QChar* out;
+    Method method;
+    int size;           // Charactors of the translation
+    QByteArray bytes;
+    QString translated;
+};
+
+/**
+ * @brief A piece of the text to be translated from Chieru into bytes of the
+ *          codec, copied to its place in the result afterwards
+ */
+struct DecodePiece {
+    const QChar* begin;
+    const QChar* end;
+    char* out;
+    QByteArray bytes;
+};
+
+/**
+ * @brief Cut [begin, end) into at most count pieces of about the same length,
+ *          each but the last ending right after a separator
+ */
+template <typename Piece>
+QVector<Piece> split_pieces(const QChar* begin, const QChar* end, int count) {
+    QVector<Piece> pieces;
+    const QChar* piece_begin = begin;
+    for (int i = 1; i < count; ++i) {
+        const QChar* target = begin + (end - begin) * i / count;
+        if (target < piece_begin) continue;
+
+        const QChar* separator = reinterpret_cast<const QChar*>(
+            chieru::find_separator(reinterpret_cast<const char16_t*>(target),
+                                   reinterpret_cast<const char16_t*>(end)));
+        if (separator == end) break;
+
+        Piece piece{};
+        piece.begin = piece_begin;
+        piece.end = separator + 1;
+        pieces.push_back(piece);
+        piece_begin = separator + 1;
+    }
+
+    Piece piece{};
+    piece.begin = piece_begin;
+    piece.end = end;
+    pieces.push_back(piece);
+    return pieces;
+}
+
+/**
+ * @brief Run fn over every piece, on the global thread pool if there are more
+ */
+template <typename Piece, typename Function>
+void for_each_piece(QVector<Piece>& pieces, Function fn) {
+    if (pieces.size() == 1)
+        fn(pieces.front());
+    else
+        QtConcurrent::blockingMap(pieces, fn);
+}
+
+/**
+ * @brief Translate a word into Chieru through the cache
+ */
+QString cached_chieru(ChieruWordCache& cache, QTextCodec* codec,
+                      const QChar* word, const QChar* word_end) {
+    int length = static_cast<int>(word_end - word);
+    QString chieru;
+    if (cache.findChieru(codec, word, length, chieru)) return chieru;
+
+    const char* bytes;
+    int bytes_length;
+    QByteArray converted;
+    {
+        CHIERU_STAT_PHASE(Codec);
+        if (is_utf8(codec)) {
+            char* buffer = reserve_word_bytes(utf8_length(word, word_end));
+            bytes_length = encode_utf8(word, word_end, buffer);
+            bytes = buffer;
+        } else {
+            converted = codec->fromUnicode(word, length);
+            CHIERU_STAT_ADD(Allocations, 1);
+            bytes = converted.constData();
+            bytes_length = converted.size();
+        }
+    }
+    CHIERU_STAT_ADD(Allocations, 1);
+    chieru.resize(1 + bytes_length * 2);
+    write_word(chieru.data(), bytes, bytes_length);
+    trim_scratch(scratch()->word_bytes);
+    cache.insertChieru(codec, word, length, chieru);
+    return chieru;
+}
+
+void size_piece(EncodePiece& piece, QTextCodec* codec, const CodecLayout& layout,
+                ChieruWordCache* cache) {
+    const QChar* begin = piece.begin;
+    const QChar* end = piece.end;
+
+    if (cache) {
+        // Words are looked up one by one, so translate them up front
+        piece.method = EncodePiece::WordByWord;
+        piece.translated.reserve(static_cast<int>(end - begin) * 2);
+        CHIERU_STAT_ADD(Allocations, 1);
+        for_each_token(begin, end, [&](const QChar* word, const QChar* word_end) {
+            QString chieru = cached_chieru(*cache, codec, word, word_end);
+            CHIERU_STAT_PHASE(Append);
+            piece.translated.append(chieru);
+        }, [&](QChar separator) {
+            CHIERU_STAT_ADD(Separators, 1);
+            piece.translated.push_back(separator);
+        });
+        piece.size = piece.translated.size();
+        return;
+    }
+
+    if (is_utf8(codec)) {
+        // The core converts utf-8 word by word itself, no need to convert ahead
+        piece.method = EncodePiece::Utf8;
+        piece.size = static_cast<int>(chieru::to_chieru_utf16_body_length(view(begin, end)));
+        return;
+    }
+
+    // Stateless codecs convert the whole piece at once, which is then cut at the
+    // separators. The sizing walk also checks that charactors and bytes line up.
+    if (layout.isSupported()) {
+        piece.method = EncodePiece::Whole;
+        {
+            CHIERU_STAT_PHASE(Codec);
+            piece.bytes = codec->fromUnicode(begin, static_cast<int>(end - begin));
+        }
+        CHIERU_STAT_ADD(Allocations, 1);
+        const char* bytes_end = piece.bytes.constData() + piece.bytes.size();
+
+        const char* cursor = piece.bytes.constData();
+        for_each_token(begin, end, [&](const QChar* word, const QChar* word_end) {
+            if (!cursor) return;
+            const char* next = layout.skip(cursor, bytes_end, word,
+                                           static_cast<int>(word_end - word));
+            if (next) piece.size += 1 + static_cast<int>(next - cursor) * 2;
+            cursor = next;
+        }, [&](QChar separator) {
+            if (!cursor) return;
+            cursor = layout.skip(cursor, bytes_end, &separator, 1);
+            ++piece.size;
+        });
+        if (cursor == bytes_end) return;
+
+        piece.size = 0;
+        piece.bytes.clear();
+    }
+
+    // Stateful codecs or text that didn't line up, convert word by word
+    piece.method = EncodePiece::WordByWord;
+    piece.translated.reserve(static_cast<int>(end - begin) * 2);
+    CHIERU_STAT_ADD(Allocations, 1);
+    for_each_token(begin, end, [&](const QChar* word, const QChar* word_end) {
+        QByteArray bytes;
+        {
+            CHIERU_STAT_PHASE(Codec);
+            bytes = codec->fromUnicode(word, static_cast<int>(word_end - word));
+        }
+        CHIERU_STAT_ADD(Allocations, 1);
+        int old_size = piece.translated.size();
+        piece.translated.resize(old_size + 1 + bytes.size() * 2);
+        write_word(piece.translated.data() + old_size, bytes.constData(), bytes.size());
+    }, [&](QChar separator) {
+        CHIERU_STAT_ADD(Separators, 1);
+        piece.translated.push_back(separator);
+    });
+    piece.size = piece.translated.size();
+}
+
+void write_piece(const EncodePiece& piece, const CodecLayout& layout) {
+    QChar* out = piece.out;
+
+    switch (piece.method) {
+    case EncodePiece::Utf8:
+        chieru::to_chieru_utf16_body(view(piece.begin, piece.end),
+                                     reinterpret_cast<char16_t*>(out));
+        break;
+    case EncodePiece::Whole: {
+        const char* cursor = piece.bytes.constData();
+        const char* bytes_end = cursor + piece.bytes.size();
+        for_each_token(piece.begin, piece.end, [&](const QChar* word, const QChar* word_end) {
+            const char* next = layout.skip(cursor, bytes_end, word,
+                                           static_cast<int>(word_end - word));
+            out = write_word(out, cursor, static_cast<int>(next - cursor));
+            cursor = next;
+        }, [&](QChar separator) {
+            CHIERU_STAT_ADD(Separators, 1);
+            cursor = layout.skip(cursor, bytes_end, &separator, 1);
+            *out++ = separator;
+        });
+        break;
+    }
+    case EncodePiece::WordByWord: {
+        CHIERU_STAT_PHASE(Append);
+        std::copy(piece.translated.begin(), piece.translated.end(), out);
+        break;
+    }
+    }
+}
+
+void decode_piece(DecodePiece& piece, QTextCodec* codec, const CodecLayout& layout,
+                  ChieruWordCache* cache) {
+    const QChar* begin = piece.begin;
+    const QChar* end = piece.end;
+    bool utf8 = is_utf8(codec);
+
+    if (utf8 && !cache) {
+        std::u16string_view body = view(begin, end);
+        piece.bytes.resize(static_cast<int>(chieru::from_chieru_utf16_body_bound(body)));
+        CHIERU_STAT_ADD(Allocations, 1);
+        piece.bytes.resize(static_cast<int>(chieru::from_chieru_utf16_body(body, piece.bytes.data())));
+        return;
+    }
+
+    // Exact for valid input under utf-8, a close guess for other codecs
+    int size = 0;
+    QString& separators = scratch()->separators;
+    separators.resize(0);  // Keeps the capacity
+    for_each_token(begin, end, [&](const QChar* word, const QChar* word_end) {
+        size += decoded_length(static_cast<int>(word_end - word));
+    }, [&](QChar separator) {
+        size += utf8_length(&separator, &separator + 1);
+        if (!utf8 && layout.isSupported()) separators.push_back(separator);
+    });
+
+    // Stateless codecs convert all the separators at once, to be handed out in
+    // order as they are met again
+    QByteArray separator_bytes;
+    const char* separator_cursor = nullptr;
+    const char* separator_end = nullptr;
+    if (!utf8 && layout.isSupported()) {
+        CHIERU_STAT_PHASE(Codec);
+        CHIERU_STAT_ADD(Allocations, 1);
+        separator_bytes = codec->fromUnicode(separators);
+        separator_cursor = separator_bytes.constData();
+        separator_end = separator_cursor + separator_bytes.size();
+        if (layout.skip(separator_cursor, separator_end, separators.constData(),
+                        separators.length()) != separator_end)
+            separator_cursor = nullptr;
+    }
+    trim_scratch(separators);
+
+    QByteArray& result = piece.bytes;
+    result.reserve(size);
+    CHIERU_STAT_ADD(Allocations, 1);
+    for_each_token(begin, end, [&](const QChar* word, const QChar* word_end) {
+        if (!cache) {
+            append_word(result, word, word_end);
+            return;
+        }
+
+        int length = static_cast<int>(word_end - word);
+        QByteArray bytes;
+        if (!cache->findBytes(word, length, bytes)) {
+            append_word(bytes, word, word_end);
+            cache->insertBytes(word, length, bytes);
+        }
+        CHIERU_STAT_PHASE(Append);
+        result.append(bytes);
+    }, [&](QChar separator) {
+        CHIERU_STAT_ADD(Separators, 1);
+        if (utf8) {
+            char bytes[3];
+            result.append(bytes, encode_utf8(&separator, &separator + 1, bytes));
+        } else if (separator_cursor) {
+            int length = layout.charLength(separator_cursor, separator_end);
+            result.append(separator_cursor, length);
+            separator_cursor += length;
+        } else {
+            CHIERU_STAT_PHASE(Codec);
+            CHIERU_STAT_ADD(Allocations, 1);
+            result.append(codec->fromUnicode(&separator, 1));
+        }
+    });
+}
 
-    for (; begin != end; ++begin) {
-        char ch = *begin;
-        result.push_back(s_chieru_charactor[ch & 15]);
-        result.push_back(s_chieru_charactor[(ch & 0xF0)>> 4]);
+QVector<EncodePiece> size_pieces(const QString& string, QTextCodec* codec,
+                                 const CodecLayout& layout, int piece_count,
+                                 ChieruWordCache* cache) {
+    const QChar* begin = string.constData();
+    const QChar* end = begin + string.length();
+
+    QVector<EncodePiece> pieces = split_pieces<EncodePiece>(begin, end, piece_count);
+    for_each_piece(pieces, [codec, &layout, cache](EncodePiece& piece) {
+        size_piece(piece, codec, layout, cache);
+    });
+    return pieces;
+}
+
+/**
+ * @brief Translate text into Chieru, with the header or without
+ */
+QString encode(const QString& string, QTextCodec* codec, bool with_header, int piece_count,
+               ChieruWordCache* cache) {
+    CodecLayout layout(is_utf8(codec) ? nullptr : codec);
+    QVector<EncodePiece> pieces = size_pieces(string, codec, layout, piece_count, cache);
+
+    int header_length = with_header ? kHeaderLength : 0;
+    int size = header_length;
+    for (const EncodePiece& piece : pieces) size += piece.size;
+
+    QString result(size, Qt::Uninitialized);
+    CHIERU_STAT_ADD(Allocations, 1);
+    QChar* out = std::copy(kHeader, kHeader + header_length, result.data());
+    for (EncodePiece& piece : pieces) {
+        piece.out = out;
+        out += piece.size;
     }
 
+    for_each_piece(pieces, [&layout](EncodePiece& piece) {
+        write_piece(piece, layout);
+    });
     return result;
 }
 
-QByteArray ChieruTranslator::chieru2word(QString::const_iterator begin,
-                                         QString::const_iterator end) {
-    QByteArray result;
+/**
+ * @brief Translate Chieru words and separators, without the header, into
+ *          bytes of the codec
+ */
+QByteArray decode(const QChar* begin, const QChar* end, QTextCodec* codec, int piece_count,
+                  ChieruWordCache* cache) {
+    CodecLayout layout(is_utf8(codec) ? nullptr : codec);
 
-    // A chieru word must start with '切', and the next charactors must be in pairs
-    if ((end - begin) < 2 || !((end - begin) & 1) || *begin != QChar(L'切'))
-        return "{ERROR}";
+    QVector<DecodePiece> pieces = split_pieces<DecodePiece>(begin, end, piece_count);
+    for_each_piece(pieces, [codec, &layout, cache](DecodePiece& piece) {
+        decode_piece(piece, codec, layout, cache);
+    });
+    if (pieces.size() == 1) return pieces.front().bytes;
 
-    for (auto itr = begin + 1; itr != end;) {
-        char32_t code;
+    int size = 0;
+    for (const DecodePiece& piece : pieces) size += piece.bytes.size();
 
-        auto dict_itr = s_dict.find(*itr);
-        if (dict_itr == s_dict.end()) return "{ERROR}";
-        code = dict_itr.value();
-        ++itr;
+    QByteArray result(size, Qt::Uninitialized);
+    CHIERU_STAT_ADD(Allocations, 1);
+    char* out = result.data();
+    for (DecodePiece& piece : pieces) {
+        piece.out = out;
+        out += piece.bytes.size();
+    }
 
-        dict_itr = s_dict.find(*itr);
-        if (dict_itr == s_dict.end()) return "{ERROR}";
-        code |= dict_itr.value() << 4;
-        ++itr;
+    for_each_piece(pieces, [](DecodePiece& piece) {
+        CHIERU_STAT_PHASE(Append);
+        std::copy(piece.bytes.constBegin(), piece.bytes.constEnd(), piece.out);
+    });
+    return result;
+}
+
+const int kStreamChunkSize = 64 * 1024;
+
+bool translate_device(QIODevice* input, QIODevice* output,
+                      ChieruStreamTranslator::Direction direction) {
+    ChieruStreamTranslator translator(direction);
+    QByteArray chunk(kStreamChunkSize, Qt::Uninitialized);
+
+    auto flush = [&]() {
+        const std::string& translated = translator.output();
+        qint64 size = static_cast<qint64>(translated.size());
+        bool written = output->write(translated.data(), size) == size;
+        translator.consume();
+        return written;
+    };
+
+    for (;;) {
+        qint64 read = input->read(chunk.data(), chunk.size());
+        if (read < 0) return false;
+        // Sequential devices may just be waiting for more
+        if (read == 0 && !input->waitForReadyRead(-1)) break;
 
-        result.push_back(code);
+        translator.push(chunk.constData(), static_cast<std::size_t>(read));
+        if (!flush()) return false;
     }
 
+    translator.finish();
+    return flush();
+}
+
+}  // namespace
+
+ChieruTranslator::ChieruTranslator()
+    : m_parallel_threshold(kDefaultParallelThreshold), m_word_cache(nullptr) {}
+
+QString ChieruTranslator::word2chieru(QByteArray::const_iterator begin,
+                                      QByteArray::const_iterator end) {
+    int length = static_cast<int>(end - begin);
+    QString result(length * 2 + 1, Qt::Uninitialized);
+    write_word(result.data(), begin, length);
+    return result;
+}
+
+QByteArray ChieruTranslator::chieru2word(QString::const_iterator begin,
+                                         QString::const_iterator end) {
+    QByteArray result;
+    result.reserve(decoded_length(static_cast<int>(end - begin)));
+    append_word(result, begin, end);
     return result;
 }
 
+chieru::DecodeStatus ChieruTranslator::decodeWord(const QChar* begin, const QChar* end,
+                                                 char* out) {
+    return chieru::decode_word(reinterpret_cast<const char16_t*>(begin),
+                               static_cast<std::size_t>(end - begin),
+                               reinterpret_cast<unsigned char*>(out));
+}
+
 QString ChieruTranslator::word2chieru(const QByteArray& word) {
     return word2chieru(word.begin(), word.end());
 }
@@ -110,46 +621,147 @@ QByteArray ChieruTranslator::chieru2word(const QString& word) {
     return chieru2word(word.begin(), word.end());
 }
 
+void ChieruTranslator::setParallelThreshold(int length) {
+    m_parallel_threshold = length;
+}
+
+int ChieruTranslator::parallelThreshold() const {
+    return m_parallel_threshold;
+}
+
+void ChieruTranslator::setWordCache(ChieruWordCache* cache) {
+    m_word_cache = cache;
+}
+
+ChieruWordCache* ChieruTranslator::wordCache() const {
+    return m_word_cache;
+}
+
+int ChieruTranslator::pieceCount(int length) const {
+    if (m_parallel_threshold <= 0 || length < m_parallel_threshold) return 1;
+    // Several pieces per thread, so that threads finishing early pick up more
+    return QThread::idealThreadCount() * 4;
+}
+
+ChieruWordCache* ChieruTranslator::wordCacheFor(int length) const {
+    // Words of long texts are translated faster in bulk than looked up
+    int limit = m_parallel_threshold > 0 ? m_parallel_threshold : kDefaultParallelThreshold;
+    return length < limit ? m_word_cache : nullptr;
+}
+
 QString ChieruTranslator::toChieru(const QString& string, QTextCodec* codec) {
-    QString result = QString::fromUtf16(u"切噜～♪");
-    assert(result.length() == 4);
-
-    int i = 0, s = 0;
-    for (int _end = string.length(); i < _end; ++i) {
-        if (is_separator(string[i])) {
-            if (s != i) {
-                result.append(word2chieru(codec->fromUnicode(string.midRef(s, i - s))));
-                s = i;
-            }
-            ++s;
-            result.push_back(string[i]);
-        }
+    return encode(string, resolve_codec(codec), true, pieceCount(string.length()), wordCacheFor(string.length()));
+}
+
+QString ChieruTranslator::fromChieru(const QString& string, QTextCodec* codec) {
+    if (!isChieru(string)) {
+        CHIERU_STAT_ERROR(chieru::DecodeError::NotChieru);
+        return QString::fromUtf8("啥？ 你突然说什么啊……不敢相信，太差劲了……");
     }
 
-    if (s != string.length())
-        result.append(word2chieru(codec->fromUnicode(string.midRef(s, string.length() - s))));
+    codec = resolve_codec(codec);
+    QByteArray bytes = decode(string.constData() + kHeaderLength,
+                              string.constData() + string.length(), codec,
+                              pieceCount(string.length()), wordCacheFor(string.length()));
+    CHIERU_STAT_PHASE(Codec);
+    CHIERU_STAT_ADD(Allocations, 1);
+    return codec->toUnicode(bytes);
+}
+
+QString ChieruTranslator::chieruHeader() {
+    return QString::fromUtf16(kHeader, kHeaderLength);
+}
+
+bool ChieruTranslator::isChieru(const QString& string) {
+    return string.length() >= kHeaderLength &&
+           std::equal(kHeader, kHeader + kHeaderLength, string.constData());
+}
+
+QString ChieruTranslator::toChieruBody(const QString& string, QTextCodec* codec) {
+    return encode(string, resolve_codec(codec), false, pieceCount(string.length()), wordCacheFor(string.length()));
+}
+
+int ChieruTranslator::toChieruBodyLength(const QString& string, QTextCodec* codec) {
+    codec = resolve_codec(codec);
+    CodecLayout layout(is_utf8(codec) ? nullptr : codec);
+
+    int size = 0;
+    for (const EncodePiece& piece :
+         size_pieces(string, codec, layout, pieceCount(string.length()), wordCacheFor(string.length())))
+        size += piece.size;
+    return size;
+}
+
+QByteArray ChieruTranslator::fromChieruBody(const QString& body, QTextCodec* codec) {
+    return decode(body.constData(), body.constData() + body.length(), resolve_codec(codec),
+                  pieceCount(body.length()), wordCacheFor(body.length()));
+}
+
+std::size_t ChieruTranslator::toChieruUtf8(std::string_view utf8, char* out) {
+    return chieru::to_chieru_utf8(utf8, out);
+}
+
+std::size_t ChieruTranslator::toChieruUtf8Bound(std::size_t length) {
+    return chieru::to_chieru_utf8_bound(length);
+}
+
+std::string ChieruTranslator::toChieruUtf8(std::string_view utf8) {
+    std::string result(toChieruUtf8Bound(utf8.size()), '\0');
+    result.resize(toChieruUtf8(utf8, &result[0]));
     return result;
 }
 
-QString ChieruTranslator::fromChieru(const QString& string, QTextCodec* codec) {
-    QByteArray result;
+std::size_t ChieruTranslator::fromChieruUtf8(std::string_view chieru, char* out) {
+    return chieru::from_chieru_utf8(chieru, out);
+}
 
-    if (string.left(4) != QString::fromUtf16(u"切噜～♪"))
-        return QString::fromUTF8("啥？ 你突然说什么啊……不敢相信，太差劲了……");
-
-    int i = 4, s = 4, _end = string.length();
-    for (; i < _end; ++i) {
-        if (is_separator(string[i])) {
-            if (s != i) {
-                result.append(chieru2word(string.begin() + s, string.begin() + i));
-                s = i;
-            }
-            ++s;
-            result.append(codec->fromUnicode(string[i]));
-        }
-    }
+std::size_t ChieruTranslator::fromChieruUtf8Bound(std::size_t length) {
+    return chieru::from_chieru_utf8_bound(length);
+}
+
+std::string ChieruTranslator::fromChieruUtf8(std::string_view chieru) {
+    std::string result(fromChieruUtf8Bound(chieru.size()), '\0');
+    result.resize(fromChieruUtf8(chieru, &result[0]));
+    return result;
+}
+
+chieru::DecodeStatus ChieruTranslator::fromChieruUtf8Strict(std::string_view chieru, char* out) {
+    return chieru::decode_utf8(chieru, out);
+}
+
+chieru::DecodeStatus ChieruTranslator::validateChieru(const QString& string) {
+    return chieru::validate(reinterpret_cast<const char16_t*>(string.constData()),
+                            static_cast<std::size_t>(string.length()));
+}
+
+chieru::DecodeStatus ChieruTranslator::validateChieruUtf8(std::string_view chieru) {
+    return chieru::validate_utf8(chieru);
+}
+
+std::size_t ChieruTranslator::fromChieruFragmentsUtf8(std::string_view text, char* out,
+                                                      const chieru::ScanOptions& options) {
+    return chieru::decode_fragments_utf8(text, out, options);
+}
+
+std::string ChieruTranslator::fromChieruFragmentsUtf8(std::string_view text,
+                                                      const chieru::ScanOptions& options) {
+    std::string result(text);
+    result.resize(fromChieruFragmentsUtf8(result, &result[0], options));
+    return result;
+}
+
+bool ChieruTranslator::toChieru(QIODevice* input, QIODevice* output) {
+    return translate_device(input, output, ChieruStreamTranslator::ToChieru);
+}
+
+bool ChieruTranslator::fromChieru(QIODevice* input, QIODevice* output) {
+    return translate_device(input, output, ChieruStreamTranslator::FromChieru);
+}
+
+chieru::StatsSnapshot ChieruTranslator::stats() {
+    return chieru::stats_snapshot();
+}
 
-    if (s != _end)
-        result.append(chieru2word(string.begin() + s, string.end()));
-    return codec->toUnicode(result);
+void ChieruTranslator::resetStats() {
+    chieru::reset_stats();
 }
@@ -10,18 +10,32 @@
  * @copyright Copyright (c) 2020
  *
  */
+#pragma once
 
 #include <QString>
-#include <QHash>
 #include <QTextCodec>
 
+#include <string>
+#include <string_view>
+
+#include "chieru_decode.h"
+#include "chieru_kernels.h"
+#include "chieru_scan.h"
+#include "chieru_stats.h"
+
+class ChieruWordCache;
+class QIODevice;
+
 class ChieruTranslator {
  private:
-    static bool s_initialized;
-    static QChar s_chieru_charactor[16];
-    static QHash<QChar, int> s_dict;
-    static QString s_symbols;
+    int m_parallel_threshold;
+    ChieruWordCache* m_word_cache;
 
+    // Count of pieces a text of the length is cut into for translation
+    int pieceCount(int length) const;
+
+    // The word cache, if texts of the length go through it
+    ChieruWordCache* wordCacheFor(int length) const;
 
  protected:
     static QString word2chieru(QByteArray::const_iterator begin,
@@ -30,25 +44,162 @@ class ChieruTranslator {
                                   QString::const_iterator end);
 
     static bool is_separator(QChar ch) {
-        if ((ch < 0x30) ||                      // before '0'
-            (ch > 0x39 && ch <= 0x40) ||        // between '9' and 'A'
-            (ch > 0x5A && ch <= 0x60) ||        // between 'Z' and 'a'
-            (ch > 0x7A && ch <= 0x7F))          // after 'z' in ascii
-            return true;
-
-        // is Chinese symbol
-        for (QChar symbol : s_symbols)
-            if (ch == symbol) return true;
-
-        return false;
+        return chieru::is_separator(ch.unicode());
     }
 
  public:
+    static const int kDefaultParallelThreshold = 1 << 20;
+
     ChieruTranslator();
 
-    void initialize();
     static QString word2chieru(const QByteArray& word);
     static QByteArray chieru2word(const QString& word);
-    QString toChieru(const QString& string, QTextCodec* codec = QTextCodec::codecForName("UTF8"));
-    QString fromChieru(const QString& string, QTextCodec* codec = QTextCodec::codecForName("UTF8"));
+
+    /**
+     * @brief Decode a word like chieru2word, but tell what is wrong instead of
+     *          writing "{ERROR}", without allocating
+     *
+     * @param out Output, must have room for (end - begin) / 2 bytes
+     */
+    static chieru::DecodeStatus decodeWord(const QChar* begin, const QChar* end, char* out);
+
+    /**
+     * @brief Translate text into Chieru, and back
+     *
+     * @param codec Codec of the bytes behind the glyphs, nullptr for utf-8
+     */
+    QString toChieru(const QString& string, QTextCodec* codec = nullptr);
+    QString fromChieru(const QString& string, QTextCodec* codec = nullptr);
+
+    /**
+     * @brief The "切噜～♪" every Chieru text starts with
+     */
+    static QString chieruHeader();
+    static bool isChieru(const QString& string);
+
+    /**
+     * @brief Translate text into Chieru without the header, so that a long text
+     *          can be translated piece by piece, cut at separators
+     */
+    QString toChieruBody(const QString& string, QTextCodec* codec = nullptr);
+
+    /**
+     * @brief Length of toChieruBody(string, codec), found without writing any
+     *          glyph
+     */
+    int toChieruBodyLength(const QString& string, QTextCodec* codec = nullptr);
+
+    /**
+     * @brief Translate Chieru without the header into bytes of the codec, left
+     *          for the caller to turn into text
+     *
+     * @note Pieces of a long text cut at separators may be decoded one by one,
+     *          and their bytes fed to one QTextDecoder
+     */
+    QByteArray fromChieruBody(const QString& body, QTextCodec* codec = nullptr);
+
+    /**
+     * @brief Texts at least this long are cut at separators and translated on
+     *          every core of the global thread pool, 0 to always stay on the
+     *          calling thread
+     *
+     * @note The result is the same either way
+     */
+    void setParallelThreshold(int length);
+    int parallelThreshold() const;
+
+    /**
+     * @brief Look words up in the cache before translating them, nullptr (the
+     *          default) to translate every word
+     *
+     * Only texts shorter than the parallel threshold (or the default one, if
+     * that is 0) go through the cache. Longer ones are translated faster by
+     * the bulk kernels than by looking their words up one by one.
+     *
+     * @note The cache isn't owned, and may be shared by translators on other
+     *          threads
+     */
+    void setWordCache(ChieruWordCache* cache);
+    ChieruWordCache* wordCache() const;
+
+    /**
+     * @brief Translate utf-8 text into utf-8 Chieru directly, without QString
+     *          and QTextCodec in between
+     *
+     * @param utf8 The text
+     * @param out Output, must have room for toChieruUtf8Bound(utf8.size()) bytes
+     * @return std::size_t Count of bytes written
+     */
+    static std::size_t toChieruUtf8(std::string_view utf8, char* out);
+    static std::size_t toChieruUtf8Bound(std::size_t length);
+    static std::string toChieruUtf8(std::string_view utf8);
+
+    /**
+     * @brief Translate utf-8 Chieru back into utf-8 text directly, without
+     *          QString and QTextCodec in between
+     *
+     * @param chieru The Chieru text
+     * @param out Output, must have room for fromChieruUtf8Bound(chieru.size())
+     *          bytes
+     * @return std::size_t Count of bytes written
+     */
+    static std::size_t fromChieruUtf8(std::string_view chieru, char* out);
+    static std::size_t fromChieruUtf8Bound(std::size_t length);
+    static std::string fromChieruUtf8(std::string_view chieru);
+
+    /**
+     * @brief Translate utf-8 Chieru like fromChieruUtf8, but stop at the first
+     *          error instead of writing "{ERROR}", without allocating
+     *
+     * @param out Output, must have room for chieru.size() bytes
+     */
+    static chieru::DecodeStatus fromChieruUtf8Strict(std::string_view chieru, char* out);
+
+    /**
+     * @brief Check that a text is Chieru and that every word of it decodes,
+     *          without decoding it anywhere
+     *
+     * @return chieru::DecodeStatus The first error, with its offset in
+     *          charactors (bytes for utf-8)
+     */
+    static chieru::DecodeStatus validateChieru(const QString& string);
+    static chieru::DecodeStatus validateChieruUtf8(std::string_view chieru);
+
+    /**
+     * @brief Decode the fragments of Chieru found in utf-8 text, passing
+     *          everything else through untouched
+     *
+     * @param out Output, must have room for text.size() bytes, may be
+     *          text.data() to decode in place
+     * @return std::size_t Count of bytes written
+     */
+    static std::size_t fromChieruFragmentsUtf8(std::string_view text, char* out,
+                                               const chieru::ScanOptions& options =
+                                                   chieru::ScanOptions());
+    static std::string fromChieruFragmentsUtf8(std::string_view text,
+                                               const chieru::ScanOptions& options =
+                                                   chieru::ScanOptions());
+
+    /**
+     * @brief Translate utf-8 read from input into utf-8 Chieru written to
+     *          output, chunk by chunk in bounded memory
+     *
+     * @return bool Whether everything was read and written
+     */
+    static bool toChieru(QIODevice* input, QIODevice* output);
+
+    /**
+     * @brief Translate utf-8 Chieru read from input into utf-8 written to
+     *          output, chunk by chunk in bounded memory
+     *
+     * @return bool Whether everything was read and written
+     */
+    static bool fromChieru(QIODevice* input, QIODevice* output);
+
+    /**
+     * @brief Counters and timings of every translation since the last
+     *          resetStats(), all zero unless built with CHIERU_STATS
+     */
+    static chieru::StatsSnapshot stats();
+    static void resetStats();
 };
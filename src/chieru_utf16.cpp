@@ -0,0 +1,165 @@
+/**
+ * @file chieru_utf16.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of utf-16 translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_utf16.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "chieru_decode.h"
+#include "chieru_kernels.h"
+#include "chieru_stats.h"
+#include "chieru_utf8.h"
+
+namespace chieru {
+
+namespace {
+
+// Words are turned into utf-8 this many code units at a time, on the stack
+constexpr std::size_t kWordChunk = 256;
+
+/**
+ * @brief Walk through the words and separators of the text in order
+ *
+ * @param on_word Called with (begin, end) of every word
+ * @param on_separator Called with every separator
+ */
+template <typename WordHandler, typename SeparatorHandler>
+void for_each_token(const char16_t* begin, const char16_t* end,
+                    WordHandler on_word, SeparatorHandler on_separator) {
+    for (const char16_t* word = begin;; ) {
+        const char16_t* separator;
+        {
+            CHIERU_STAT_PHASE(Separators);
+            separator = find_separator(word, end);
+        }
+        if (separator != word) on_word(word, separator);
+        if (separator == end) break;
+
+        on_separator(*separator);
+        word = separator + 1;
+    }
+}
+
+char* append(char* dst, std::string_view bytes) {
+    std::memcpy(dst, bytes.data(), bytes.size());
+    return dst + bytes.size();
+}
+
+// Separators are never surrogates, so they take at most three bytes
+char* append_separator(char* dst, char16_t separator) {
+    return dst + encode_utf8(&separator, 1, reinterpret_cast<unsigned char*>(dst));
+}
+
+}  // namespace
+
+std::size_t to_chieru_utf16_body_length(std::u16string_view text) {
+    std::size_t length = 0;
+    for_each_token(text.data(), text.data() + text.size(), [&](const char16_t* word, const char16_t* word_end) {
+        length += 1 + utf8_length(word, static_cast<std::size_t>(word_end - word)) * 2;
+    }, [&](char16_t) {
+        ++length;
+    });
+    return length;
+}
+
+std::size_t to_chieru_utf16_body(std::u16string_view text, char16_t* dst) {
+    char16_t* out = dst;
+    for_each_token(text.data(), text.data() + text.size(), [&](const char16_t* word, const char16_t* word_end) {
+        CHIERU_STAT_PHASE(Encode);
+        CHIERU_STAT_ADD(EncodedWords, 1);
+        *out++ = kGlyphs[0];  // '切'
+
+        unsigned char bytes[kWordChunk * 3];
+        while (word != word_end) {
+            // Surrogate pairs stay in one chunk
+            const char16_t* chunk_end = word + std::min<std::size_t>(kWordChunk, word_end - word);
+            if (chunk_end != word_end && (chunk_end[-1] & 0xFC00) == 0xD800) --chunk_end;
+
+            std::size_t length = encode_utf8(word, static_cast<std::size_t>(chunk_end - word), bytes);
+            encode_nibbles(bytes, length, out);
+            CHIERU_STAT_ADD(EncodedBytes, length);
+            out += length * 2;
+            word = chunk_end;
+        }
+    }, [&](char16_t separator) {
+        CHIERU_STAT_ADD(Separators, 1);
+        *out++ = separator;
+    });
+    return static_cast<std::size_t>(out - dst);
+}
+
+std::size_t to_chieru_utf16(std::u16string_view text, char16_t* dst) {
+    char16_t* out = std::copy(kUtf16Header.begin(), kUtf16Header.end(), dst);
+    return kUtf16Header.size() + to_chieru_utf16_body(text, out);
+}
+
+std::size_t from_chieru_utf16_body_bound(std::u16string_view body) {
+    std::size_t length = 0;
+    for_each_token(body.data(), body.data() + body.size(), [&](const char16_t* word, const char16_t* word_end) {
+        length += std::max(static_cast<std::size_t>(word_end - word) / 2, kUtf8Error.size());
+    }, [&](char16_t separator) {
+        length += utf8_length(&separator, 1);
+    });
+    return length;
+}
+
+std::size_t from_chieru_utf16_body(std::u16string_view body, char* dst) {
+    char* out = dst;
+    for_each_token(body.data(), body.data() + body.size(), [&](const char16_t* word, const char16_t* word_end) {
+        CHIERU_STAT_PHASE(Decode);
+        CHIERU_STAT_ADD(DecodedWords, 1);
+        DecodeStatus status = decode_word(word, static_cast<std::size_t>(word_end - word),
+                                          reinterpret_cast<unsigned char*>(out));
+        if (!status) {
+            CHIERU_STAT_ERROR(status.error);
+            out = append(out, kUtf8Error);
+            return;
+        }
+        CHIERU_STAT_ADD(DecodedBytes, status.length);
+        out += status.length;
+    }, [&](char16_t separator) {
+        CHIERU_STAT_ADD(Separators, 1);
+        out = append_separator(out, separator);
+    });
+    return static_cast<std::size_t>(out - dst);
+}
+
+std::size_t from_chieru_utf16_bound(std::u16string_view chieru) {
+    if (chieru.substr(0, kUtf16Header.size()) != kUtf16Header) return kUtf8NotChieru.size();
+    return from_chieru_utf16_body_bound(chieru.substr(kUtf16Header.size()));
+}
+
+std::size_t from_chieru_utf16(std::u16string_view chieru, char* dst) {
+    if (chieru.substr(0, kUtf16Header.size()) != kUtf16Header) {
+        CHIERU_STAT_ERROR(DecodeError::NotChieru);
+        return static_cast<std::size_t>(append(dst, kUtf8NotChieru) - dst);
+    }
+    return from_chieru_utf16_body(chieru.substr(kUtf16Header.size()), dst);
+}
+
+}  // namespace chieru
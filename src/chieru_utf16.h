@@ -0,0 +1,102 @@
+/**
+ * @file chieru_utf16.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Qt-free translation of utf-16 text, as toChieru and fromChieru do
+ *          with the utf-8 codec
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace chieru {
+
+inline constexpr std::u16string_view kUtf16Header = u"切噜～♪";
+
+/**
+ * @brief Exact size of to_chieru_utf16_body(text), in code units
+ */
+std::size_t to_chieru_utf16_body_length(std::u16string_view text);
+
+/**
+ * @brief Translate utf-16 text into Chieru without the header. Words are
+ *          turned into utf-8 first, lone surrogates into '?'.
+ *
+ * @param dst Output, must have room for to_chieru_utf16_body_length(text) code
+ *          units
+ * @return std::size_t Count of code units written
+ */
+std::size_t to_chieru_utf16_body(std::u16string_view text, char16_t* dst);
+
+/**
+ * @brief Exact size of to_chieru_utf16(text), in code units
+ */
+inline std::size_t to_chieru_utf16_length(std::u16string_view text) {
+    return kUtf16Header.size() + to_chieru_utf16_body_length(text);
+}
+
+/**
+ * @brief Translate utf-16 text into Chieru, with the header
+ *
+ * @param dst Output, must have room for to_chieru_utf16_length(text) code units
+ * @return std::size_t Count of code units written
+ */
+std::size_t to_chieru_utf16(std::u16string_view text, char16_t* dst);
+
+/**
+ * @brief Size of the buffer from_chieru_utf16_body may need for body, in bytes
+ *
+ * Only the separators are looked for, so it is quick, and exact unless some
+ * words are malformed.
+ */
+std::size_t from_chieru_utf16_body_bound(std::u16string_view body);
+
+/**
+ * @brief Translate Chieru without the header back into the utf-8 bytes it was
+ *          made of, "{ERROR}" for malformed words
+ *
+ * @param dst Output, must have room for from_chieru_utf16_body_bound(body)
+ *          bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t from_chieru_utf16_body(std::u16string_view body, char* dst);
+
+/**
+ * @brief Size of the buffer from_chieru_utf16 may need for chieru, in bytes
+ */
+std::size_t from_chieru_utf16_bound(std::u16string_view chieru);
+
+/**
+ * @brief Translate Chieru back into utf-8, the complaint of fromChieru if it
+ *          doesn't start with the header
+ *
+ * @param dst Output, must have room for from_chieru_utf16_bound(chieru) bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t from_chieru_utf16(std::u16string_view chieru, char* dst);
+
+}  // namespace chieru
@@ -0,0 +1,193 @@
+/**
+ * @file chieru_utf8.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the utf-8 translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_utf8.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "chieru_decode.h"
+#include "chieru_kernels.h"
+#include "chieru_stats.h"
+
+namespace chieru {
+
+namespace {
+
+char* append(char* dst, std::string_view bytes) {
+    std::memcpy(dst, bytes.data(), bytes.size());
+    return dst + bytes.size();
+}
+
+/**
+ * @brief Walk through the words and separators of the utf-8 text in order
+ *
+ * @param on_word Called with (begin, end) of every word
+ * @param on_separator Called with (begin, end) of every separator
+ */
+template <typename WordHandler, typename SeparatorHandler>
+void for_each_token(const char* begin, const char* end,
+                    WordHandler on_word, SeparatorHandler on_separator) {
+    for (const char* word = begin;; ) {
+        const char* separator;
+        {
+            CHIERU_STAT_PHASE(Separators);
+            separator = find_separator_utf8(word, end);
+        }
+        if (separator != word) on_word(word, separator);
+        if (separator == end) break;
+
+        const char* separator_end = separator + utf8_separator_length(separator, end);
+        on_separator(separator, separator_end);
+        word = separator_end;
+    }
+}
+
+/**
+ * @brief Translate the body of utf-8 Chieru back, see from_chieru_utf8_body
+ *
+ * @tparam kExact Whether dst is sized by from_chieru_utf8_body_length, with no
+ *          room for a bad word past its "{ERROR}"
+ */
+template <bool kExact>
+std::size_t decode_body(std::string_view body, char* dst) {
+    char* out = dst;
+    for_each_token(body.data(), body.data() + body.size(), [&](const char* word, const char* word_end) {
+        CHIERU_STAT_PHASE(Decode);
+        CHIERU_STAT_ADD(DecodedWords, 1);
+
+        // '切' followed by pairs of three byte glyphs, as in chieru2word
+        std::string_view glyphs(word, static_cast<std::size_t>(word_end - word));
+        bool headed = glyphs.substr(0, kUtf8WordHead.size()) == kUtf8WordHead;
+        if (!headed || glyphs.size() == kUtf8WordHead.size() ||
+            (glyphs.size() - kUtf8WordHead.size()) % 6) {
+            CHIERU_STAT_ERROR(headed ? DecodeError::OddLength : DecodeError::BadPrefix);
+            out = append(out, kUtf8Error);
+            return;
+        }
+
+        // Without room to spare a bad word only has room for "{ERROR}", so
+        // longer words are checked before anything is written past that
+        glyphs.remove_prefix(kUtf8WordHead.size());
+        if (kExact && glyphs.size() / 6 > kUtf8Error.size()) {
+            DecodeStatus status = decode_word_utf8(word, static_cast<std::size_t>(word_end - word),
+                                                   nullptr);
+            if (!status) {
+                CHIERU_STAT_ERROR(status.error);
+                out = append(out, kUtf8Error);
+                return;
+            }
+        }
+
+        std::size_t decoded = decode_nibbles_utf8(glyphs.data(), glyphs.size(),
+                                                  reinterpret_cast<unsigned char*>(out));
+        if (decoded != glyphs.size()) {
+            // Over what was decoded of the word
+            CHIERU_STAT_ERROR(DecodeError::UnknownGlyph);
+            out = append(out, kUtf8Error);
+        } else {
+            CHIERU_STAT_ADD(DecodedBytes, glyphs.size() / 6);
+            out += glyphs.size() / 6;
+        }
+    }, [&](const char* separator, const char* separator_end) {
+        CHIERU_STAT_ADD(Separators, 1);
+        out = std::copy(separator, separator_end, out);
+    });
+
+    return static_cast<std::size_t>(out - dst);
+}
+
+}  // namespace
+
+std::size_t from_chieru_utf8_bound(std::size_t length) {
+    // A word may turn into "{ERROR}", which is at most 7 times longer
+    return std::max(length * kUtf8Error.size(), kUtf8NotChieru.size());
+}
+
+std::size_t to_chieru_utf8(std::string_view text, char* dst) {
+    char* out = append(dst, kUtf8Header);
+    return kUtf8Header.size() + to_chieru_utf8_body(text, out);
+}
+
+std::size_t from_chieru_utf8(std::string_view chieru, char* dst) {
+    if (chieru.substr(0, kUtf8Header.size()) != kUtf8Header) {
+        CHIERU_STAT_ERROR(DecodeError::NotChieru);
+        return static_cast<std::size_t>(append(dst, kUtf8NotChieru) - dst);
+    }
+
+    return from_chieru_utf8_body(chieru.substr(kUtf8Header.size()), dst);
+}
+
+std::size_t to_chieru_utf8_body(std::string_view text, char* dst) {
+    char* out = dst;
+    for_each_token(text.data(), text.data() + text.size(), [&](const char* word, const char* word_end) {
+        CHIERU_STAT_PHASE(Encode);
+        CHIERU_STAT_ADD(EncodedWords, 1);
+        CHIERU_STAT_ADD(EncodedBytes, word_end - word);
+        out = append(out, kUtf8WordHead);
+        encode_nibbles_utf8(reinterpret_cast<const unsigned char*>(word),
+                            static_cast<std::size_t>(word_end - word), out);
+        out += (word_end - word) * 6;
+    }, [&](const char* separator, const char* separator_end) {
+        CHIERU_STAT_ADD(Separators, 1);
+        out = std::copy(separator, separator_end, out);
+    });
+
+    return static_cast<std::size_t>(out - dst);
+}
+
+std::size_t to_chieru_utf8_body_length(std::string_view text) {
+    std::size_t length = 0;
+    for_each_token(text.data(), text.data() + text.size(), [&](const char* word, const char* word_end) {
+        length += kUtf8WordHead.size() + static_cast<std::size_t>(word_end - word) * 6;
+    }, [&](const char* separator, const char* separator_end) {
+        length += static_cast<std::size_t>(separator_end - separator);
+    });
+    return length;
+}
+
+std::size_t from_chieru_utf8_body(std::string_view body, char* dst) {
+    return decode_body<false>(body, dst);
+}
+
+std::size_t from_chieru_utf8_body_exact(std::string_view body, char* dst) {
+    return decode_body<true>(body, dst);
+}
+
+std::size_t from_chieru_utf8_body_length(std::string_view body) {
+    std::size_t length = 0;
+    for_each_token(body.data(), body.data() + body.size(), [&](const char* word, const char* word_end) {
+        // Only checked here, which is as fast as decoding into a scratch buffer
+        bool valid = decode_word_utf8(word, static_cast<std::size_t>(word_end - word), nullptr).ok();
+        length += valid ? static_cast<std::size_t>(word_end - word) / 6 : kUtf8Error.size();
+    }, [&](const char* separator, const char* separator_end) {
+        length += static_cast<std::size_t>(separator_end - separator);
+    });
+    return length;
+}
+
+}  // namespace chieru
@@ -0,0 +1,130 @@
+/**
+ * @file chieru_utf8.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Qt-free translation between utf-8 text and utf-8 Chieru
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @warning This file should be encoded in UTF-8
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace chieru {
+
+/**
+ * @brief Fixed pieces of Chieru in utf-8
+ */
+// 切噜～♪
+inline constexpr std::string_view kUtf8Header = "\xE5\x88\x87\xE5\x99\x9C\xEF\xBD\x9E\xE2\x99\xAA";
+// 切
+inline constexpr std::string_view kUtf8WordHead = "\xE5\x88\x87";
+inline constexpr std::string_view kUtf8Error = "{ERROR}";
+// 啥？ 你突然说什么啊……不敢相信，太差劲了……
+inline constexpr std::string_view kUtf8NotChieru =
+    "\xE5\x95\xA5\xEF\xBC\x9F\x20\xE4\xBD\xA0\xE7\xAA\x81\xE7\x84\xB6\xE8\xAF"
+    "\xB4\xE4\xBB\x80\xE4\xB9\x88\xE5\x95\x8A\xE2\x80\xA6\xE2\x80\xA6\xE4\xB8"
+    "\x8D\xE6\x95\xA2\xE7\x9B\xB8\xE4\xBF\xA1\xEF\xBC\x8C\xE5\xA4\xAA\xE5\xB7"
+    "\xAE\xE5\x8A\xB2\xE4\xBA\x86\xE2\x80\xA6\xE2\x80\xA6";
+
+/**
+ * @brief Size of the buffer to_chieru_utf8 may need for length bytes of input
+ */
+constexpr std::size_t to_chieru_utf8_bound(std::size_t length) {
+    // Header, then at worst one byte words: '切' and two glyphs for every byte
+    return 12 + length * 9;
+}
+
+/**
+ * @brief Size of the buffer from_chieru_utf8 may need for length bytes of input
+ */
+std::size_t from_chieru_utf8_bound(std::size_t length);
+
+/**
+ * @brief Translate utf-8 text into utf-8 Chieru, like toChieru with the utf-8
+ *          codec but without leaving utf-8
+ *
+ * @param text The text, invalid utf-8 is encoded byte by byte
+ * @param dst Output, must have room for to_chieru_utf8_bound(text.size()) bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t to_chieru_utf8(std::string_view text, char* dst);
+
+/**
+ * @brief Translate utf-8 Chieru back into utf-8 text, like fromChieru with the
+ *          utf-8 codec but without leaving utf-8
+ *
+ * @param chieru The Chieru text
+ * @param dst Output, must have room for from_chieru_utf8_bound(chieru.size())
+ *          bytes
+ * @return std::size_t Count of bytes written
+ *
+ * @note Decoded words are written as they are, so they are only valid utf-8 if
+ *          the encoded text was
+ */
+std::size_t from_chieru_utf8(std::string_view chieru, char* dst);
+
+/**
+ * @brief Translate utf-8 text into utf-8 Chieru without the header, so that a
+ *          text cut right after separators can be translated piece by piece
+ *
+ * @param dst Output, must have room for to_chieru_utf8_body_length(text) bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t to_chieru_utf8_body(std::string_view text, char* dst);
+
+/**
+ * @brief Exact size of to_chieru_utf8_body(text), found without writing it
+ */
+std::size_t to_chieru_utf8_body_length(std::string_view text);
+
+/**
+ * @brief Translate utf-8 Chieru without the header back into utf-8 text, in
+ *          one pass over every word
+ *
+ * @param dst Output, must have room for from_chieru_utf8_bound(body.size())
+ *          bytes
+ * @return std::size_t Count of bytes written
+ */
+std::size_t from_chieru_utf8_body(std::string_view body, char* dst);
+
+/**
+ * @brief Like from_chieru_utf8_body, into output sized exactly, so that pieces
+ *          can be written next to each other
+ *
+ * Words that would be written past their "{ERROR}" are checked first instead,
+ * which takes a second pass over them.
+ *
+ * @param dst Output, must have room for from_chieru_utf8_body_length(body)
+ *          bytes
+ */
+std::size_t from_chieru_utf8_body_exact(std::string_view body, char* dst);
+
+/**
+ * @brief Exact size of from_chieru_utf8_body(body), found without writing it
+ */
+std::size_t from_chieru_utf8_body_length(std::string_view body);
+
+}  // namespace chieru
@@ -0,0 +1,235 @@
+/**
+ * @file chieru_word_cache.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of the word cache
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "chieru_word_cache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+// Rough cost of an entry besides its key and value: list node, hash node and
+// the headers of the Qt containers
+const std::size_t kEntryOverhead = 96;
+
+struct Key {
+    const QTextCodec* codec;    // nullptr for Chieru words to bytes
+    std::u16string_view word;
+
+    bool operator==(const Key& other) const {
+        return codec == other.codec && word == other.word;
+    }
+};
+
+struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+        return std::hash<std::u16string_view>()(key.word) ^
+               std::hash<const void*>()(key.codec) * 31;
+    }
+};
+
+std::u16string_view view_of(const QChar* word, int length) {
+    return std::u16string_view(reinterpret_cast<const char16_t*>(word),
+                               static_cast<std::size_t>(length));
+}
+
+// Chieru of a word, or bytes of a Chieru word
+struct Translation {
+    QString chieru;
+    QByteArray bytes;
+};
+
+/**
+ * @brief Least recently used map from words to translations, not thread safe
+ */
+class LruMap {
+ public:
+    bool find(const Key& key, Translation& value) {
+        auto found = m_index.find(key);
+        if (found == m_index.end()) return false;
+
+        // Most recently used first
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        value = found->second->value;
+        return true;
+    }
+
+    /**
+     * @return std::size_t Count of entries evicted to stay under max_bytes
+     */
+    std::size_t insert(const Key& key, const Translation& value, std::size_t& bytes,
+                       std::size_t max_bytes) {
+        if (m_index.count(key)) return 0;
+
+        m_entries.push_front(Entry{key.codec, std::u16string(key.word), value});
+        Entry& entry = m_entries.front();
+        // The key views the word owned by the entry, which never moves
+        m_index.emplace(Key{entry.codec, entry.word}, m_entries.begin());
+        bytes += cost(entry);
+
+        std::size_t evictions = 0;
+        while (bytes > max_bytes && !m_entries.empty()) {
+            Entry& oldest = m_entries.back();
+            bytes -= cost(oldest);
+            m_index.erase(Key{oldest.codec, oldest.word});
+            m_entries.pop_back();
+            ++evictions;
+        }
+        return evictions;
+    }
+
+    std::size_t size() const { return m_entries.size(); }
+
+    void clear() {
+        m_index.clear();
+        m_entries.clear();
+    }
+
+ private:
+    struct Entry {
+        const QTextCodec* codec;
+        std::u16string word;
+        Translation value;
+    };
+
+    static std::size_t cost(const Entry& entry) {
+        return entry.word.size() * sizeof(char16_t) +
+               static_cast<std::size_t>(entry.value.chieru.size()) * sizeof(QChar) +
+               static_cast<std::size_t>(entry.value.bytes.size()) + kEntryOverhead;
+    }
+
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+};
+
+}  // namespace
+
+struct ChieruWordCache::Shard {
+    QMutex mutex;
+    LruMap entries;
+    std::size_t memory = 0;
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 evictions = 0;
+};
+
+ChieruWordCache::ChieruWordCache(std::size_t max_bytes, int shards)
+    : m_max_bytes(max_bytes),
+      m_shard_count(shards > 0 ? shards : 1),
+      m_shards(new Shard[static_cast<std::size_t>(m_shard_count)]) {}
+
+ChieruWordCache::~ChieruWordCache() = default;
+
+ChieruWordCache::Shard& ChieruWordCache::shardOf(std::size_t hash) {
+    // The low bits pick the bucket inside the shard, so use the high ones here
+    return m_shards[(hash >> 16) % static_cast<std::size_t>(m_shard_count)];
+}
+
+bool ChieruWordCache::findChieru(const QTextCodec* codec, const QChar* word, int length,
+                                 QString& chieru) {
+    if (length > kMaxWordLength) return false;
+
+    Key key{codec, view_of(word, length)};
+    Shard& shard = shardOf(KeyHash()(key));
+    QMutexLocker locker(&shard.mutex);
+    Translation translation;
+    bool found = shard.entries.find(key, translation);
+    ++(found ? shard.hits : shard.misses);
+    if (found) chieru = translation.chieru;
+    return found;
+}
+
+void ChieruWordCache::insertChieru(const QTextCodec* codec, const QChar* word, int length,
+                                   const QString& chieru) {
+    if (length > kMaxWordLength) return;
+
+    Key key{codec, view_of(word, length)};
+    Shard& shard = shardOf(KeyHash()(key));
+    QMutexLocker locker(&shard.mutex);
+    shard.evictions += shard.entries.insert(key, Translation{chieru, QByteArray()}, shard.memory,
+                                            m_max_bytes / static_cast<std::size_t>(m_shard_count));
+}
+
+bool ChieruWordCache::findBytes(const QChar* chieru, int length, QByteArray& bytes) {
+    if (length > kMaxWordLength) return false;
+
+    Key key{nullptr, view_of(chieru, length)};
+    Shard& shard = shardOf(KeyHash()(key));
+    QMutexLocker locker(&shard.mutex);
+    Translation translation;
+    bool found = shard.entries.find(key, translation);
+    ++(found ? shard.hits : shard.misses);
+    if (found) bytes = translation.bytes;
+    return found;
+}
+
+void ChieruWordCache::insertBytes(const QChar* chieru, int length, const QByteArray& bytes) {
+    if (length > kMaxWordLength) return;
+
+    Key key{nullptr, view_of(chieru, length)};
+    Shard& shard = shardOf(KeyHash()(key));
+    QMutexLocker locker(&shard.mutex);
+    shard.evictions += shard.entries.insert(key, Translation{QString(), bytes}, shard.memory,
+                                            m_max_bytes / static_cast<std::size_t>(m_shard_count));
+}
+
+ChieruWordCache::Stats ChieruWordCache::stats() const {
+    Stats stats = {};
+    for (int i = 0; i < m_shard_count; ++i) {
+        Shard& shard = m_shards[static_cast<std::size_t>(i)];
+        QMutexLocker locker(&shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.memory;
+    }
+    return stats;
+}
+
+void ChieruWordCache::resetStats() {
+    for (int i = 0; i < m_shard_count; ++i) {
+        Shard& shard = m_shards[static_cast<std::size_t>(i)];
+        QMutexLocker locker(&shard.mutex);
+        shard.hits = shard.misses = shard.evictions = 0;
+    }
+}
+
+void ChieruWordCache::clear() {
+    for (int i = 0; i < m_shard_count; ++i) {
+        Shard& shard = m_shards[static_cast<std::size_t>(i)];
+        QMutexLocker locker(&shard.mutex);
+        shard.entries.clear();
+        shard.memory = 0;
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file chieru_word_cache.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Bounded cache of translated words
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstddef>
+#include <memory>
+
+class QTextCodec;
+
+/**
+ * @brief Remembers the translations of recently seen words, for texts that
+ *          repeat the same short words over and over
+ *
+ * Words are mapped to their Chieru under a codec, and Chieru words back to
+ * their bytes. Decoding gives the same bytes under every codec, so the codec
+ * isn't part of those keys.
+ *
+ * Entries are spread over shards by hash, each shard with its own lock and its
+ * own least recently used order, so threads rarely wait for each other. Every
+ * shard gets an equal part of the memory cap.
+ *
+ * @note Words longer than kMaxWordLength are never cached
+ */
+class ChieruWordCache {
+ public:
+    static const int kMaxWordLength = 64;
+
+    struct Stats {
+        quint64 hits;
+        quint64 misses;
+        quint64 evictions;
+        std::size_t entries;
+        std::size_t bytes;      // Estimated memory of the entries
+    };
+
+    /**
+     * @param max_bytes Memory cap of all the entries together, estimated
+     * @param shards Count of shards, more for more threads
+     */
+    explicit ChieruWordCache(std::size_t max_bytes = 4 * 1024 * 1024, int shards = 16);
+    ~ChieruWordCache();
+
+    ChieruWordCache(const ChieruWordCache&) = delete;
+    ChieruWordCache& operator=(const ChieruWordCache&) = delete;
+
+    /**
+     * @brief Look up the Chieru of a word under the codec
+     *
+     * @return bool Whether it was found, and chieru set
+     */
+    bool findChieru(const QTextCodec* codec, const QChar* word, int length, QString& chieru);
+    void insertChieru(const QTextCodec* codec, const QChar* word, int length, const QString& chieru);
+
+    /**
+     * @brief Look up the bytes of a Chieru word
+     *
+     * @return bool Whether it was found, and bytes set
+     */
+    bool findBytes(const QChar* chieru, int length, QByteArray& bytes);
+    void insertBytes(const QChar* chieru, int length, const QByteArray& bytes);
+
+    Stats stats() const;
+    void resetStats();
+    void clear();
+
+    std::size_t maxBytes() const { return m_max_bytes; }
+
+ private:
+    struct Shard;
+
+    Shard& shardOf(std::size_t hash);
+
+    std::size_t m_max_bytes;
+    int m_shard_count;
+    std::unique_ptr<Shard[]> m_shards;
+};
@@ -1,7 +1,7 @@
 /**
- * @file chieru_translator.cpp
+ * @file cli.cpp
  * @author H1MSK (ksda47832338@outlook.com)
- * @brief Crude cli
+ * @brief Crude cli, and a translation daemon
  * @version 0.1
  * @date 2020-07-20
  * 
@@ -26,21 +26,159 @@
  * THE SOFTWARE.
  */
 
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <algorithm>
 #include <iostream>
+#include "chieru_file.h"
+#include "chieru_server.h"
 #include "chieru_translator.h"
 
-int main() {
-    ChieruTranslator *translator = new ChieruTranslator();
-    while(1) {
+namespace {
+
+int run_repl() {
+    while (1) {
         std::string line;
         std::cout << ">>";
         std::flush(std::cout);
-        std::getline(std::cin, line);
+        if (!std::getline(std::cin, line)) return 0;
+        if (line.empty()) continue;
+
+        std::string_view text = std::string_view(line).substr(std::min<std::size_t>(2, line.size()));
         if (line.front() == '1')
-            std::cout <<translator->toUTF8(line.substr(2)) <<std::endl;
+            std::cout <<ChieruTranslator::toChieruUtf8(text) <<std::endl;
         else if (line.front() == '0')
-            std::cout <<translator->fromUTF8(line.substr(2)) <<std::endl;
+            std::cout <<ChieruTranslator::fromChieruUtf8(text) <<std::endl;
         else if (line.front() == 'q')
-            exit(0);
+            return 0;
+    }
+}
+
+// Copy input to output line by line, decoding the Chieru found in every line
+int run_scan(const chieru::ScanOptions& options) {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        line.resize(ChieruTranslator::fromChieruFragmentsUtf8(line, &line[0], options));
+        std::cout <<line <<'\n';
+    }
+    std::cout.flush();
+    return 0;
+}
+
+// Print what the translator counted, see chieru_stats.h
+void print_stats() {
+    chieru::StatsSnapshot stats = ChieruTranslator::stats();
+    if (!stats.enabled) {
+        std::cerr <<"No statistics, build with \"qmake CONFIG+=chieru_stats\" for them" <<std::endl;
+        return;
+    }
+
+    for (int i = 0; i < chieru::kStatCounterCount; ++i) {
+        auto counter = static_cast<chieru::StatCounter>(i);
+        std::cerr <<chieru::stat_counter_name(counter) <<": " <<stats.counter(counter) <<'\n';
+    }
+    for (int i = 0; i < chieru::kStatPhaseCount; ++i) {
+        auto phase = static_cast<chieru::StatPhase>(i);
+        std::cerr <<chieru::stat_phase_name(phase) <<": " <<stats.calls(phase) <<" calls, ~"
+                  <<stats.nanoseconds(phase) / 1e6 <<" ms\n";
+    }
+    std::cerr.flush();
+}
+
+int run_file(const QString& input, const QString& output,
+             ChieruFileTranslator::Direction direction, int threads) {
+    ChieruFileTranslator translator(direction, threads);
+    if (!translator.translate(input, output)) {
+        std::cerr <<qPrintable(translator.errorString()) <<std::endl;
+        return 1;
+    }
+
+    const ChieruFileTranslator::Report& report = translator.report();
+    std::cerr <<"Translated " <<report.input_bytes <<" bytes into " <<report.output_bytes
+              <<" bytes in " <<report.nanoseconds / 1e9 <<" s ("
+              <<report.megabytesPerSecond() <<" MB/s, " <<report.pieces <<" pieces)"
+              <<std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Translates \"1 <text>\" into Chieru and \"0 <text>\" back, line by line.\n"
+        "With --listen or --port, serves the same requests to other processes instead.\n"
+        "With --scan, copies input to output, decoding the Chieru found in it.\n"
+        "With --input and --output, translates a whole file into another.\n"
+        "With --stats, prints counters and timings of the translator at the end.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"listen", "Serve on the local socket (unix domain socket or named pipe) <name>.", "name"},
+        {"port", "Serve on tcp <port> of localhost.", "port"},
+        {"framing", "Requests as \"line\" (default) or 32-bit big-endian \"length\" prefixed.",
+         "framing", "line"},
+        {"threads", "Worker threads of the server, one per core by default.", "count", "0"},
+        {"scan", "Decode the Chieru fragments of every input line, pass the rest through."},
+        {"headerless", "With --scan, also decode runs of words without \"切噜～♪\"."},
+        {"min-words", "Words a run without header needs to be decoded.", "count", "2"},
+        {"input", "Translate the utf-8 <file> into Chieru, memory mapped.", "file"},
+        {"output", "With --input, write the translation to <file>.", "file"},
+        {"decode", "With --input, translate Chieru back instead."},
+        {"stats", "Print what the translator counted to stderr when done."},
+        {"metrics-port", "Serve the statistics over http on <port> of localhost.", "port"},
+    });
+    parser.process(app);
+
+    if (!parser.isSet("listen") && !parser.isSet("port")) {
+        int status;
+        if (parser.isSet("input")) {
+            if (!parser.isSet("output")) {
+                std::cerr <<"--input needs --output" <<std::endl;
+                return 1;
+            }
+            status = run_file(parser.value("input"), parser.value("output"),
+                              parser.isSet("decode") ? ChieruFileTranslator::FromChieru
+                                                     : ChieruFileTranslator::ToChieru,
+                              parser.value("threads").toInt());
+        } else if (parser.isSet("scan")) {
+            chieru::ScanOptions options;
+            options.headerless = parser.isSet("headerless");
+            options.min_words = parser.value("min-words").toUInt();
+            status = run_scan(options);
+        } else {
+            status = run_repl();
+        }
+
+        if (parser.isSet("stats")) print_stats();
+        return status;
+    }
+
+    ChieruServer::Framing framing;
+    if (parser.value("framing") == "line") {
+        framing = ChieruServer::LineFraming;
+    } else if (parser.value("framing") == "length") {
+        framing = ChieruServer::LengthFraming;
+    } else {
+        std::cerr <<"Unknown framing: " <<qPrintable(parser.value("framing")) <<std::endl;
+        return 1;
+    }
+
+    ChieruServer server(framing, parser.value("threads").toInt());
+    if (parser.isSet("listen") && !server.listenLocal(parser.value("listen"))) {
+        std::cerr <<qPrintable(server.errorString()) <<std::endl;
+        return 1;
+    }
+    if (parser.isSet("port") && !server.listenTcp(parser.value("port").toUShort())) {
+        std::cerr <<qPrintable(server.errorString()) <<std::endl;
+        return 1;
+    }
+    if (parser.isSet("metrics-port") &&
+        !server.listenMetrics(parser.value("metrics-port").toUShort())) {
+        std::cerr <<qPrintable(server.errorString()) <<std::endl;
+        return 1;
     }
-}
\ No newline at end of file
+    return app.exec();
+}
@@ -0,0 +1,29 @@
+# Command line translator and translation daemon
+#
+# Shares the source directory with translator.pro, so build it out of source:
+#   mkdir build-cli && cd build-cli && qmake ../cli.pro && make
+
+QT       += core network concurrent
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = chieru_cli
+
+SOURCES += \
+    chieru_file.cpp \
+    chieru_server.cpp \
+    chieru_translator.cpp \
+    cli.cpp \
+    chieru_word_cache.cpp \
+    codec_layout.cpp
+
+HEADERS += \
+    chieru_file.h \
+    chieru_server.h \
+    chieru_translator.h \
+    chieru_word_cache.h \
+    codec_layout.h
+
+include(chieru_core.pri)
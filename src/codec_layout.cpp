@@ -0,0 +1,114 @@
+/**
+ * @file codec_layout.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of codec layouts
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "codec_layout.h"
+
+#include <QChar>
+#include <QTextCodec>
+
+namespace {
+
+CodecLayout::Kind kind_of(const QTextCodec* codec) {
+    int mib = codec->mibEnum();
+
+    // ISO-8859-1 to ISO-8859-10, ISO-8859-13 to ISO-8859-16, windows-125x, KOI8
+    if ((mib >= 4 && mib <= 13) || (mib >= 109 && mib <= 112) ||
+        (mib >= 2250 && mib <= 2258) || mib == 2084 || mib == 2088)
+        return CodecLayout::SingleByte;
+
+    switch (mib) {
+    case 113:   // GBK
+    case 114:   // GB18030
+    case 2025:  // GB2312
+        return CodecLayout::Gb18030;
+    case 2026:  // Big5
+    case 2101:  // Big5-HKSCS
+        return CodecLayout::Big5;
+    case 17:    // Shift_JIS
+        return CodecLayout::ShiftJis;
+    case 18:    // EUC-JP
+        return CodecLayout::EucJp;
+    case 38:    // EUC-KR
+        return CodecLayout::EucKr;
+    default:
+        return CodecLayout::Unsupported;
+    }
+}
+
+}  // namespace
+
+CodecLayout::CodecLayout(const QTextCodec* codec)
+    : m_kind(codec ? kind_of(codec) : Unsupported) {}
+
+int CodecLayout::charLength(const char* begin, const char* end) const {
+    if (begin == end) return 0;
+
+    unsigned char lead = static_cast<unsigned char>(*begin);
+    int length = 1;
+    switch (m_kind) {
+    case Gb18030:
+        if (lead >= 0x81 && lead <= 0xFE) {
+            // A digit as second byte makes it a four byte sequence
+            length = 2;
+            if (end - begin >= 2 && begin[1] >= '0' && begin[1] <= '9') length = 4;
+        }
+        break;
+    case Big5:
+    case EucKr:
+        if (lead >= 0x81 && lead <= 0xFE) length = 2;
+        break;
+    case ShiftJis:
+        if ((lead >= 0x81 && lead <= 0x9F) || (lead >= 0xE0 && lead <= 0xFC)) length = 2;
+        break;
+    case EucJp:
+        if (lead == 0x8F) length = 3;
+        else if (lead == 0x8E || (lead >= 0xA1 && lead <= 0xFE)) length = 2;
+        break;
+    default:
+        break;
+    }
+
+    return end - begin >= length ? length : 0;
+}
+
+const char* CodecLayout::skip(const char* begin, const char* end,
+                              const QChar* chars, int count) const {
+    for (int i = 0; i < count; ++i) {
+        if (chars[i].isSurrogate()) return nullptr;
+
+        int length = charLength(begin, end);
+        if (length == 0) return nullptr;
+
+        // Ascii stays ascii in every supported codec, which keeps us in sync
+        if (chars[i].unicode() < 0x80 &&
+            (length != 1 || static_cast<unsigned char>(*begin) != chars[i].unicode()))
+            return nullptr;
+
+        begin += length;
+    }
+    return begin;
+}
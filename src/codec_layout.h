@@ -0,0 +1,80 @@
+/**
+ * @file codec_layout.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Charactor boundaries inside text encoded by a QTextCodec
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+class QChar;
+class QTextCodec;
+
+/**
+ * @brief Tells where every charactor starts in text converted by a stateless
+ *          codec, so that a whole string can be converted at once and then cut
+ *          at its separators
+ *
+ * Stateful codecs (ISO-2022-*), codecs with byte order marks (UTF-16/32) and
+ * unknown ones are unsupported, and must be converted piece by piece instead.
+ */
+class CodecLayout {
+ public:
+    enum Kind {
+        Unsupported,
+        SingleByte,
+        Gb18030,    // Also GBK and GB2312
+        Big5,
+        ShiftJis,
+        EucJp,
+        EucKr
+    };
+
+    explicit CodecLayout(const QTextCodec* codec);
+
+    Kind kind() const { return m_kind; }
+    bool isSupported() const { return m_kind != Unsupported; }
+
+    /**
+     * @brief Length of the encoded charactor starting at begin
+     *
+     * @return int The length, 0 if the charactor is cut off by end
+     */
+    int charLength(const char* begin, const char* end) const;
+
+    /**
+     * @brief Skip the encoding of count charactors
+     *
+     * @param begin Start of the encoded charactors
+     * @param end End of the encoded text
+     * @param chars The charactors that were encoded
+     * @param count Count of charactors to skip
+     * @return const char* End of the skipped bytes, or nullptr when the
+     *          charactors can't be lined up with the bytes (the text contains
+     *          surrogates, or runs out)
+     */
+    const char* skip(const char* begin, const char* end, const QChar* chars, int count) const;
+
+ private:
+    Kind m_kind;
+};
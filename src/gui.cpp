@@ -32,51 +32,55 @@
 #include <QTextCodec>
 #include <QResizeEvent>
 #include <QDateTime>
-#include <QPixmap>
-#include <QLabel>
-#include <QGraphicsOpacityEffect>
-#include <QDebug>
 #include <QFontDatabase>
+#include <QTextCursor>
 
 #include <cstdlib>
 
+#include "background.h"
+#include "chieru_async.h"
 #include "chieru_translator.h"
+#include "live_translation.h"
 #include "singleton.h"
 
+// Texts longer than this are translated in the background, chunk by chunk
+static const int kLargeDocumentLength = 256 * 1024;
+
 TranslatorWidget::TranslatorWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::EncoderWidget)
     , m_translator(Instance<ChieruTranslator>())
-    , m_horizontal_background(nullptr)
-    , m_vertical_background(nullptr)
-    , m_current_background(nullptr)
-    , m_background_label(new QLabel(this))
-    , m_current_codec(QTextCodec::codecForName("UTF8")) {
+    , m_background(nullptr)
+    , m_current_codec(QTextCodec::codecForName("UTF8"))
+    , m_live_translation(nullptr)
+    , m_task(new TranslationTask(m_translator, this))
+    , m_task_target(nullptr)
+    , m_async(new ChieruAsyncTranslator(m_translator))
+    , m_async_watcher(new QFutureWatcher<QString>(this))
+    , m_async_target(nullptr) {
     ui->setupUi(this);
 
-    srand(QDateTime::currentMSecsSinceEpoch());
-    int total;
-    for (total = 0; QFile::exists(QString(":/imgs/chieruh%1.png").arg(total)); ++total) {
-        qDebug() <<"Found: " <<QString(":/imgs/chieruh%1.png").arg(total);
-    }
-    m_horizontal_background = new QPixmap(QString(":/imgs/chieruh%1.png").arg(rand() % total));
-
-    for (total = 0; QFile::exists(QString(":/imgs/chieruv%1.png").arg(total)); ++total) {
-        qDebug() <<"Found: " <<QString(":/imgs/chieruv%1.png").arg(total);
-    }
-    m_vertical_background = new QPixmap(QString(":/imgs/chieruv%1.png").arg(rand() % total));
-
-    m_current_background = m_horizontal_background;
+    m_live_translation = new LiveTranslation(m_translator, ui->textedit_original,
+                                             ui->textedit_translated, this);
+    m_live_translation->setCodec(m_current_codec);
+
+    m_task->setStreaming(true);
+    connect(m_task, &TranslationTask::chunkReady, this, [this](const QString &chunk) {
+        // Appending keeps the view where it is, so the window stays responsive
+        QTextCursor cursor(m_task_target->document());
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(chunk);
+    });
+    connect(m_task, &TranslationTask::progress, ui->progress_translation, &QProgressBar::setValue);
+    connect(m_task, &TranslationTask::finished, this, [this]() { setTranslating(false); });
+
+    connect(m_async_watcher, &QFutureWatcher<QString>::finished, this, [this]() {
+        if (!m_async_watcher->isCanceled())
+            m_live_translation->setText(m_async_target, m_async_watcher->result());
+    });
 
-    m_background_label->setAttribute(Qt::WA_TransparentForMouseEvents);
-    m_background_label->resize(size());
-    m_background_label->show();
-    m_background_label->setPixmap(*m_horizontal_background);
-
-    QGraphicsOpacityEffect *effect = new QGraphicsOpacityEffect(m_background_label);
-    effect->setEnabled(true);
-    effect->setOpacity(0.2);
-    m_background_label->setGraphicsEffect(effect);
+    srand(QDateTime::currentMSecsSinceEpoch());
+    m_background = new Background(this);
 
 #ifdef ANDROID
     QFont f = ui->textedit_original->font();
@@ -86,17 +90,20 @@ TranslatorWidget::TranslatorWidget(QWidget *parent)
 #endif
 
     ui->combo_chieru->hide();
+    ui->progress_translation->hide();
+    ui->button_cancel->hide();
 
     updateUI();
 }
 
 TranslatorWidget::~TranslatorWidget()
 {
+    delete m_async;
     delete ui;
 }
 
 void TranslatorWidget::resizeEvent(QResizeEvent *event) {
-    m_background_label->resize(event->size());
+    Q_UNUSED(event)
     updateUI();
 }
 
@@ -110,8 +117,6 @@ void TranslatorWidget::updateUI() {
             ui->layout_control->setDirection(QBoxLayout::LeftToRight);
             ui->button_to_string->setText(QString("\xE2\x86\x91")); // ↑
             ui->button_from_string->setText(QString("\xE2\x86\x93")); // ↓
-
-            m_current_background = m_vertical_background;
         } else {
             if (width() < height()) break;
 
@@ -120,41 +125,89 @@ void TranslatorWidget::updateUI() {
             ui->layout_control->setDirection(QBoxLayout::TopToBottom);
             ui->button_to_string->setText(QString("\xE2\x86\x90")); // ←
             ui->button_from_string->setText(QString("\xE2\x86\x92")); // →
-
-            m_current_background = m_horizontal_background;
         }
     } while(0);
 
-    // Change background and center it
-    QPixmap background = m_current_background->scaled(size(), Qt::KeepAspectRatioByExpanding);
+    m_background->update(ui->central_layout->direction() == QBoxLayout::LeftToRight
+                             ? Background::Horizontal : Background::Vertical,
+                         size());
+}
 
-    m_background_label->resize(background.size());
-    if (background.width() > width()) {
-        m_background_label->move((width() - background.width()) / 2, 0);
-    } else {
-        m_background_label->move(0, (height() - background.height()) / 2);
+void TranslatorWidget::on_button_from_string_clicked() {
+    QString origianl_string = ui->textedit_original->toPlainText();
+    if (origianl_string.length() > kLargeDocumentLength) {
+        translateLarge(TranslationTask::ToChieru, origianl_string, ui->textedit_translated);
+        return;
     }
-    m_background_label->setPixmap(background);
 
-    m_background_label->raise();
+    translateAsync(m_async->toChieru(origianl_string, m_current_codec), ui->textedit_translated);
 }
 
-void TranslatorWidget::on_button_from_string_clicked() {
-    QString translated_string =
-            m_translator->toChieru(ui->textedit_original->toPlainText(), m_current_codec);
+void TranslatorWidget::on_button_to_string_clicked() {
+    QString translated_string = ui->textedit_translated->toPlainText();
+    if (translated_string.length() > kLargeDocumentLength) {
+        translateLarge(TranslationTask::FromChieru, translated_string, ui->textedit_original);
+        return;
+    }
 
-    ui->textedit_translated->setPlainText(translated_string);
+    translateAsync(m_async->fromChieru(translated_string, m_current_codec), ui->textedit_original);
 }
 
-void TranslatorWidget::on_button_to_string_clicked() {
-    QString origianl_string =
-            m_translator->fromChieru(ui->textedit_translated->toPlainText(), m_current_codec);
+void TranslatorWidget::on_button_cancel_clicked() {
+    m_task->cancel();
+    setTranslating(false);
+}
+
+void TranslatorWidget::translateAsync(const QFuture<QString> &translation,
+                                      QPlainTextEdit *target) {
+    // The last click wins, what the one before would write is stale. A click
+    // on the same text again gets the same translation back, which must go on.
+    if (m_async_watcher->future() != translation) m_async_watcher->cancel();
+    m_async_target = target;
+    m_async_watcher->setFuture(translation);
+}
+
+void TranslatorWidget::translateLarge(TranslationTask::Direction direction, const QString &text,
+                                      QPlainTextEdit *target) {
+    // A smaller translation still running would write over this one
+    m_async_watcher->cancel();
+
+    // Live translation would follow every chunk written
+    ui->check_live->setChecked(false);
+
+    // Undo steps of the chunks would keep another copy of the translation
+    m_task_target = target;
+    m_task_target->setUndoRedoEnabled(false);
+    m_task_target->clear();
 
-    ui->textedit_original->setPlainText(origianl_string);
+    ui->progress_translation->setRange(0, text.length());
+    ui->progress_translation->setValue(0);
+    setTranslating(true);
+
+    m_task->start(direction, text, m_current_codec);
+}
+
+void TranslatorWidget::setTranslating(bool translating) {
+    ui->button_from_string->setEnabled(!translating);
+    ui->button_to_string->setEnabled(!translating);
+    ui->check_live->setEnabled(!translating);
+    ui->combo_encode->setEnabled(!translating);
+    ui->textedit_original->setReadOnly(translating);
+    ui->textedit_translated->setReadOnly(translating);
+
+    ui->progress_translation->setVisible(translating);
+    ui->button_cancel->setVisible(translating);
+
+    if (!translating && m_task_target) m_task_target->setUndoRedoEnabled(true);
 }
 
 void TranslatorWidget::on_combo_encode_currentIndexChanged(const QString &arg1) {
     m_current_codec = QTextCodec::codecForName(arg1.toUtf8());
+    m_live_translation->setCodec(m_current_codec);
+}
+
+void TranslatorWidget::on_check_live_toggled(bool checked) {
+    m_live_translation->setEnabled(checked);
 }
 
 int main(int argc, char *argv[]) {
@@ -27,16 +27,21 @@
  */
 #pragma once
 
+#include <QFutureWatcher>
 #include <QWidget>
 
+#include "translation_task.h"
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class EncoderWidget; }
 QT_END_NAMESPACE
 
+class ChieruAsyncTranslator;
 class ChieruTranslator;
+class LiveTranslation;
+class Background;
 class QTextCodec;
-class QPixmap;
-class QLabel;
+class QPlainTextEdit;
 
 class TranslatorWidget : public QWidget
 {
@@ -57,11 +62,28 @@ private slots:
 
     void on_combo_encode_currentIndexChanged(const QString &arg1);
 
+    void on_check_live_toggled(bool checked);
+
+    void on_button_cancel_clicked();
+
 private:
+    // Write the translation to target once it is done, unless another one
+    // starts first
+    void translateAsync(const QFuture<QString> &translation, QPlainTextEdit *target);
+
+    // Translate text in the background, appending to target as it goes
+    void translateLarge(TranslationTask::Direction direction, const QString &text,
+                        QPlainTextEdit *target);
+    void setTranslating(bool translating);
 
     Ui::EncoderWidget *ui;
     ChieruTranslator *m_translator;
-    QPixmap *m_horizontal_background, *m_vertical_background, *m_current_background;
-    QLabel* m_background_label;
+    Background *m_background;
     QTextCodec *m_current_codec;
+    LiveTranslation *m_live_translation;
+    TranslationTask *m_task;
+    QPlainTextEdit *m_task_target;
+    ChieruAsyncTranslator *m_async;
+    QFutureWatcher<QString> *m_async_watcher;
+    QPlainTextEdit *m_async_target;
 };
@@ -0,0 +1,280 @@
+/**
+ * @file live_translation.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of live translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "live_translation.h"
+
+#include <QPlainTextEdit>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTimer>
+
+#include "chieru_kernels.h"
+#include "chieru_translator.h"
+#include "translation_task.h"
+
+namespace {
+
+// Edits larger than this are translated as a whole, in the background
+const int kMaxPatchLength = 16 * 1024;
+
+// Blocks that grew past this are cut again
+const int kMaxBlockLength = 4 * TranslationTask::kPieceLength;
+
+// Quiet time before a whole text is translated, in milliseconds
+const int kRetranslateDelay = 100;
+const int kTranslateBackDelay = 200;
+
+// Documents hold paragraph separators and non-breaking spaces where
+// toPlainText() has '\n' and ' '
+QChar plain(QChar ch) {
+    if (ch == QChar::ParagraphSeparator) return QChar('\n');
+    if (ch == QChar::Nbsp) return QChar(' ');
+    return ch;
+}
+
+bool is_separator(QChar ch) {
+    return chieru::is_separator(plain(ch).unicode());
+}
+
+// [from, to) of the document as toPlainText() would have it
+QString text_of(QTextDocument *document, int from, int to) {
+    QTextCursor cursor(document);
+    cursor.setPosition(from);
+    cursor.setPosition(to, QTextCursor::KeepAnchor);
+
+    QString text = cursor.selectedText();
+    for (QChar &ch : text) ch = plain(ch);
+    return text;
+}
+
+int length_of(QTextDocument *document) {
+    return document->characterCount() - 1;
+}
+
+}  // namespace
+
+LiveTranslation::LiveTranslation(ChieruTranslator *translator, QPlainTextEdit *original,
+                                 QPlainTextEdit *translated, QObject *parent)
+    : QObject(parent)
+    , m_translator(translator)
+    , m_original(original)
+    , m_translated(translated)
+    , m_codec(nullptr)
+    , m_task(new TranslationTask(translator, this))
+    , m_retranslate_timer(new QTimer(this))
+    , m_translate_back_timer(new QTimer(this))
+    , m_enabled(false)
+    , m_updating(false)
+    , m_indexed(false)
+    , m_translating_back(false) {
+    m_retranslate_timer->setSingleShot(true);
+    m_retranslate_timer->setInterval(kRetranslateDelay);
+    m_translate_back_timer->setSingleShot(true);
+    m_translate_back_timer->setInterval(kTranslateBackDelay);
+
+    connect(m_retranslate_timer, &QTimer::timeout, this, &LiveTranslation::retranslate);
+    connect(m_translate_back_timer, &QTimer::timeout, this, [this]() {
+        m_translating_back = true;
+        m_task->start(TranslationTask::FromChieru, m_translated->toPlainText(), m_codec);
+    });
+    connect(m_task, &TranslationTask::finished, this, &LiveTranslation::finished);
+
+    connect(m_original->document(), &QTextDocument::contentsChange,
+            this, &LiveTranslation::originalChanged);
+    connect(m_translated->document(), &QTextDocument::contentsChange,
+            this, &LiveTranslation::translatedChanged);
+}
+
+void LiveTranslation::setEnabled(bool enabled) {
+    m_enabled = enabled;
+    m_indexed = false;
+    m_task->cancel();
+    m_retranslate_timer->stop();
+    m_translate_back_timer->stop();
+
+    if (enabled) retranslate();
+}
+
+void LiveTranslation::setCodec(QTextCodec *codec) {
+    m_codec = codec;
+    m_indexed = false;
+    if (m_enabled) retranslate();
+}
+
+void LiveTranslation::setText(QPlainTextEdit *pane, const QString &text) {
+    // Whatever is pending works on the text being replaced
+    m_task->cancel();
+    m_retranslate_timer->stop();
+    m_translate_back_timer->stop();
+
+    m_updating = true;
+    pane->setPlainText(text);
+    m_updating = false;
+
+    m_indexed = false;
+    if (m_enabled && pane == m_translated) retranslate();
+}
+
+void LiveTranslation::originalChanged(int position, int removed, int added) {
+    if (!m_enabled || m_updating) return;
+
+    m_translate_back_timer->stop();
+    if (m_indexed && patch(position, removed, added)) return;
+
+    m_indexed = false;
+    retranslateLater();
+}
+
+void LiveTranslation::translatedChanged(int position, int removed, int added) {
+    Q_UNUSED(position)
+    Q_UNUSED(removed)
+    Q_UNUSED(added)
+    if (!m_enabled || m_updating) return;
+
+    // The user writes Chieru now, translate it back once they pause
+    m_indexed = false;
+    m_task->cancel();
+    m_retranslate_timer->stop();
+    m_translate_back_timer->start();
+}
+
+bool LiveTranslation::patch(int position, int removed, int added) {
+    QTextDocument *original = m_original->document();
+    QTextDocument *translated = m_translated->document();
+    int length = length_of(original);
+    if (removed > kMaxPatchLength || added > kMaxPatchLength) return false;
+
+    int original_total = 0, translated_total = 0;
+    for (const Block &block : m_blocks) {
+        original_total += block.original_length;
+        translated_total += block.translated_length;
+    }
+    int header_length = ChieruTranslator::chieruHeader().length();
+    if (original_total != length - added + removed ||
+        length_of(translated) != header_length + translated_total)
+        return false;
+
+    // Widen the edit to whole words. Text before the edit and after it is the
+    // same as before the edit, so are these words boundaries in the old text.
+    int word_begin = position;
+    while (word_begin > 0 && !is_separator(original->characterAt(word_begin - 1))) {
+        // Words this long are left to the background
+        if (position - word_begin == kMaxPatchLength) return false;
+        --word_begin;
+    }
+    int edit_end = qMin(position + added, length);
+    int word_end = edit_end;
+    while (word_end < length && !is_separator(original->characterAt(word_end))) {
+        if (word_end - edit_end == kMaxPatchLength) return false;
+        ++word_end;
+    }
+    int old_word_end = word_end - added + removed;
+
+    // Blocks holding the old words, first from the start, then to the end
+    int first = 0, block_begin = 0, translated_begin = 0;
+    while (first + 1 < m_blocks.size() &&
+           block_begin + m_blocks[first].original_length <= word_begin) {
+        block_begin += m_blocks[first].original_length;
+        translated_begin += m_blocks[first].translated_length;
+        ++first;
+    }
+    int last = first;
+    int block_end = block_begin + m_blocks[first].original_length;
+    int translated_end = translated_begin + m_blocks[first].translated_length;
+    while (last + 1 < m_blocks.size() && block_end < old_word_end) {
+        ++last;
+        block_end += m_blocks[last].original_length;
+        translated_end += m_blocks[last].translated_length;
+    }
+    int new_block_end = block_end + added - removed;
+
+    // Translations of the unchanged words around the edit are only measured
+    int prefix = m_translator->toChieruBodyLength(text_of(original, block_begin, word_begin),
+                                                  m_codec);
+    int suffix = m_translator->toChieruBodyLength(text_of(original, word_end, new_block_end),
+                                                  m_codec);
+    QString words = m_translator->toChieruBody(text_of(original, word_begin, word_end), m_codec);
+
+    int from = header_length + translated_begin + prefix;
+    int to = header_length + translated_end - suffix;
+    m_updating = true;
+    QTextCursor cursor(translated);
+    cursor.setPosition(from);
+    cursor.setPosition(to, QTextCursor::KeepAnchor);
+    cursor.insertText(words);
+    m_updating = false;
+
+    Block merged = {new_block_end - block_begin, prefix + words.length() + suffix};
+    replaceBlocks(first, last, block_begin, merged);
+    return true;
+}
+
+void LiveTranslation::replaceBlocks(int first, int last, int position, const Block &merged) {
+    m_blocks.remove(first + 1, last - first);
+    m_blocks[first] = merged;
+    if (merged.original_length <= kMaxBlockLength) return;
+
+    QString text = text_of(m_original->document(), position, position + merged.original_length);
+    QVector<Block> blocks;
+    int offset = 0;
+    for (int length : TranslationTask::cut(text, 0, text.length())) {
+        blocks.push_back({length, m_translator->toChieruBodyLength(text.mid(offset, length),
+                                                                  m_codec)});
+        offset += length;
+    }
+
+    m_blocks.remove(first);
+    for (int i = 0; i < blocks.size(); ++i) m_blocks.insert(first + i, blocks[i]);
+}
+
+void LiveTranslation::retranslateLater() {
+    // Whatever runs now translates a text that is gone
+    m_task->cancel();
+    m_retranslate_timer->start();
+}
+
+void LiveTranslation::retranslate() {
+    m_retranslate_timer->stop();
+    m_translating_back = false;
+    m_task->start(TranslationTask::ToChieru, m_original->toPlainText(), m_codec);
+}
+
+void LiveTranslation::finished(const TranslationResult &result) {
+    m_updating = true;
+    if (m_translating_back) {
+        m_original->setPlainText(result.text);
+    } else {
+        // Keeps the cursor and undo steps when only the index was rebuilt
+        if (m_translated->toPlainText() != result.text) m_translated->setPlainText(result.text);
+
+        m_blocks.clear();
+        for (int i = 0; i < result.original_lengths.size(); ++i)
+            m_blocks.push_back({result.original_lengths[i], result.translated_lengths[i]});
+        m_indexed = true;
+    }
+    m_updating = false;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file live_translation.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Translation that follows the edits of the user
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+class ChieruTranslator;
+class QPlainTextEdit;
+class QString;
+class QTextCodec;
+class QTimer;
+class TranslationTask;
+struct TranslationResult;
+
+/**
+ * @brief Keeps one pane translated from the other while the user types
+ *
+ * An edit of the original re-translates only the words it touches and patches
+ * the matching range of the translated pane. For that the text is tracked as
+ * blocks cut at separators, each knowing its length before and after
+ * translation, so that an edit finds its place in the translation by looking
+ * at one block instead of the whole text.
+ *
+ * Whole texts are translated in the background instead: when live translation
+ * starts, after large edits, and after edits of the translated pane, which are
+ * translated back. Newer input cancels those.
+ */
+class LiveTranslation : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiveTranslation(ChieruTranslator *translator, QPlainTextEdit *original,
+                    QPlainTextEdit *translated, QObject *parent = nullptr);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    void setCodec(QTextCodec *codec);
+
+    /**
+     * @brief Replace the text of a pane without taking it for an edit of the
+     *          user, so that nothing is translated back over the other pane
+     *
+     * The translated pane is indexed again in the background, the original one
+     * by its next edit.
+     */
+    void setText(QPlainTextEdit *pane, const QString &text);
+
+private:
+    struct Block {
+        int original_length;
+        int translated_length;
+    };
+
+    void originalChanged(int position, int removed, int added);
+    void translatedChanged(int position, int removed, int added);
+
+    /**
+     * @brief Re-translate the words touched by an edit of the original
+     *
+     * @return bool Whether the translated pane could be patched, otherwise it
+     *          must be translated again as a whole
+     */
+    bool patch(int position, int removed, int added);
+
+    // Replace the blocks of the merged one, cutting it again when it grew long
+    void replaceBlocks(int first, int last, int position, const Block &merged);
+
+    void retranslateLater();
+    void retranslate();
+    void translateBackLater();
+    void finished(const TranslationResult &result);
+
+    ChieruTranslator *m_translator;
+    QPlainTextEdit *m_original;
+    QPlainTextEdit *m_translated;
+    QTextCodec *m_codec;
+    TranslationTask *m_task;
+    QTimer *m_retranslate_timer;
+    QTimer *m_translate_back_timer;
+
+    bool m_enabled;
+    bool m_updating;        // Set while a pane is written by this
+    bool m_indexed;         // m_blocks describe the panes as they are
+    bool m_translating_back;
+    QVector<Block> m_blocks;
+};
@@ -2,8 +2,8 @@
  * @file singleton.h
  * @author H1MSK (ksda47832338@outlook.com)
  * @brief A handy singleton library
- * @version 0.3
- * @date 2020-07-20
+ * @version 0.4
+ * @date 2026-10-17
  * 
  * @copyright Copyright (c) 2020
  * 
@@ -26,8 +26,13 @@
  * THE SOFTWARE.
  */
 
+#pragma once
+
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 #include <mutex>
+#include <new>
 
 /**
  * @brief A handy macro that defines a private constructor and
@@ -55,40 +60,51 @@ struct InstanceWrapper {
         return raw_pointer;
     }
     const Type* operator->() const {
-        assert(initialized = true);
+        assert(initialized == true);
         return raw_pointer;
     }
 
     operator Type*() {
-        assert(initialized = true);
+        assert(initialized == true);
         return raw_pointer;
     }
 };
 
 /**
- * @brief Class that actually stores the instance and the access mutex
+ * @brief Class that actually stores the instance and the construction mutex
+ * 
+ * The pointer is only published, with release order, once the instance is
+ * fully constructed, so a thread that loads it with acquire order sees the
+ * whole instance and never needs the mutex.
  * 
  * @tparam Type The type of the class
  */
 template <typename Type>
 struct InstanceSafetyHelper {
-    InstanceWrapper<Type> wrapper;
+    std::atomic<Type*> pointer;
     std::mutex mutex;
 
     static InstanceSafetyHelper* Helper() {
         static InstanceSafetyHelper<Type> helper;
         return &helper;
     }
-    InstanceSafetyHelper() : wrapper{false, nullptr}, mutex() {}
+    InstanceSafetyHelper() : pointer(nullptr), mutex() {}
     ~InstanceSafetyHelper() {
-        wrapper.raw_pointer->~Type();
-        free(wrapper.raw_pointer);
+        Type* instance = pointer.load(std::memory_order_acquire);
+        if (instance == nullptr) return;
+        instance->~Type();
+        free(instance);
+    }
+
+    InstanceWrapper<Type> wrapper() const {
+        Type* instance = pointer.load(std::memory_order_acquire);
+        return InstanceWrapper<Type>{instance != nullptr, instance};
     }
 };
 
 /**
  * @brief Get the instance of the indicate type, construct one when not
- * constructed (thread safe)
+ * constructed (thread safe, lock-free once constructed)
  *
  * @tparam Type The type of the instance
  * @tparam ConstructParameters Parameters used in construction
@@ -98,18 +114,17 @@ struct InstanceSafetyHelper {
 template <typename Type, typename... ConstructParameters>
 Type* Instance(ConstructParameters... args) {
     InstanceSafetyHelper<Type>* helper = InstanceSafetyHelper<Type>::Helper();
-    if (helper->wrapper.raw_pointer == nullptr) {
-        helper->mutex.lock();
-        if (helper->wrapper.raw_pointer == nullptr) {
+    Type* instance = helper->pointer.load(std::memory_order_acquire);
+    if (instance == nullptr) {
+        std::lock_guard<std::mutex> locker(helper->mutex);
+        instance = helper->pointer.load(std::memory_order_relaxed);
+        if (instance == nullptr) {
             void* data = malloc(sizeof(Type));
-            helper->wrapper.raw_pointer =
-                reinterpret_cast<Type*>(data);
-            helper->wrapper.raw_pointer = new (data) Type(args...);
-            helper->wrapper.initialized = true;
+            instance = new (data) Type(args...);
+            helper->pointer.store(instance, std::memory_order_release);
         }
-        helper->mutex.unlock();
     }
-    return helper->wrapper;
+    return instance;
 }
 /**
  * @brief Get the Instance with the indicated type after asserting its existance
@@ -120,6 +135,27 @@ Type* Instance(ConstructParameters... args) {
 template <typename Type>
 InstanceWrapper<Type> getInstance(void) {
     InstanceSafetyHelper<Type>* helper = InstanceSafetyHelper<Type>::Helper();
-    assert(helper->wrapper.raw_pointer != nullptr);
-    return helper->wrapper;
+    InstanceWrapper<Type> wrapper = helper->wrapper();
+    assert(wrapper.raw_pointer != nullptr);
+    return wrapper;
+}
+
+/**
+ * @brief Get the instance of the indicate type that belongs to the calling
+ * thread, construct one on the first call from every thread
+ *
+ * Meant for scratch state, like buffers reused from one translation to the
+ * next, that workers would otherwise share or allocate again every time.
+ * Every thread destroys its own instance when it exits.
+ *
+ * @tparam Type The type of the instance
+ * @tparam ConstructParameters Parameters used in construction
+ * @param args Parameters used in construction, ignored after the first call of
+ *          the thread
+ * @return Type* The instance of the calling thread
+ */
+template <typename Type, typename... ConstructParameters>
+Type* ThreadInstance(ConstructParameters... args) {
+    thread_local Type instance(args...);
+    return &instance;
 }
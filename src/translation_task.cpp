@@ -0,0 +1,203 @@
+/**
+ * @file translation_task.cpp
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Implementation of background translation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "translation_task.h"
+
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QTextCodec>
+#include <QTimer>
+#include <QWaitCondition>
+#include <QtConcurrent>
+
+#include <atomic>
+
+#include "chieru_kernels.h"
+#include "chieru_translator.h"
+
+/**
+ * @brief What a running task shares with the TranslationTask that started it
+ */
+struct TranslationTask::State {
+    std::atomic<bool> cancelled;
+    std::atomic<int> done;
+    int total;
+    bool streaming;
+
+    // Streamed translation not taken yet
+    QMutex mutex;
+    QWaitCondition taken;
+    QString pending;
+
+    State(int total, bool streaming)
+        : cancelled(false), done(0), total(total), streaming(streaming) {}
+};
+
+namespace {
+
+// Streamed chunks piling up past this many charactors make the task wait
+const int kMaxPendingLength = 256 * 1024;
+
+// Keep a translated piece, then tell whether to go on
+bool emit_piece(TranslationResult &result, TranslationTask::State *state,
+                const QString &piece, int done) {
+    if (!state->streaming) {
+        result.text.append(piece);
+    } else {
+        QMutexLocker locker(&state->mutex);
+        while (state->pending.length() > kMaxPendingLength && !state->cancelled)
+            state->taken.wait(&state->mutex, TranslationTask::kStreamInterval);
+        state->pending.append(piece);
+    }
+
+    state->done = done;
+    return !state->cancelled;
+}
+
+TranslationResult translate(ChieruTranslator *translator, TranslationTask::Direction direction,
+                            const QString &text, QTextCodec *codec,
+                            TranslationTask::State *state) {
+    TranslationResult result;
+
+    if (direction == TranslationTask::ToChieru) {
+        result.original_lengths = TranslationTask::cut(text, 0, text.length());
+        if (!emit_piece(result, state, ChieruTranslator::chieruHeader(), 0))
+            return TranslationResult();
+
+        int position = 0;
+        for (int length : result.original_lengths) {
+            QString translated = translator->toChieruBody(text.mid(position, length), codec);
+            result.translated_lengths.push_back(translated.length());
+            position += length;
+
+            if (!emit_piece(result, state, translated, position)) return TranslationResult();
+        }
+        return result;
+    }
+
+    if (!ChieruTranslator::isChieru(text)) {
+        emit_piece(result, state, translator->fromChieru(text, codec), text.length());
+        return result;
+    }
+
+    // Bytes of a charactor may be split between pieces, which the decoder
+    // keeps until the rest arrives
+    if (!codec) codec = QTextCodec::codecForName("UTF-8");
+    QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+
+    int position = ChieruTranslator::chieruHeader().length();
+    for (int length : TranslationTask::cut(text, position, text.length())) {
+        QString translated =
+            decoder->toUnicode(translator->fromChieruBody(text.mid(position, length), codec));
+        position += length;
+
+        if (!emit_piece(result, state, translated, position)) return TranslationResult();
+    }
+    return result;
+}
+
+}  // namespace
+
+TranslationTask::TranslationTask(ChieruTranslator *translator, QObject *parent)
+    : QObject(parent)
+    , m_translator(translator)
+    , m_watcher(nullptr)
+    , m_stream_timer(new QTimer(this))
+    , m_streaming(false) {
+    m_stream_timer->setInterval(kStreamInterval);
+    connect(m_stream_timer, &QTimer::timeout, this, &TranslationTask::drain);
+}
+
+TranslationTask::~TranslationTask() {
+    cancel();
+}
+
+void TranslationTask::start(Direction direction, const QString &text, QTextCodec *codec) {
+    cancel();
+
+    QSharedPointer<State> state(new State(text.length(), m_streaming));
+    m_state = state;
+
+    QFutureWatcher<TranslationResult> *watcher = new QFutureWatcher<TranslationResult>(this);
+    m_watcher = watcher;
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        // Cancelled while running
+        if (watcher != m_watcher) return;
+
+        // Whoever takes the last chunk may cancel or start another task
+        drain();
+        if (watcher != m_watcher) return;
+
+        m_stream_timer->stop();
+        m_watcher = nullptr;
+        m_state.reset();
+        emit finished(watcher->result());
+    });
+
+    ChieruTranslator *translator = m_translator;
+    watcher->setFuture(QtConcurrent::run([translator, direction, text, codec, state]() {
+        return translate(translator, direction, text, codec, state.data());
+    }));
+    m_stream_timer->start();
+}
+
+void TranslationTask::cancel() {
+    if (m_state) {
+        m_state->cancelled = true;
+        m_state->taken.wakeAll();
+    }
+    m_state.reset();
+    m_watcher = nullptr;
+    m_stream_timer->stop();
+}
+
+void TranslationTask::drain() {
+    QSharedPointer<State> state = m_state;
+    if (!state) return;
+
+    QString chunk;
+    if (state->streaming) {
+        QMutexLocker locker(&state->mutex);
+        chunk.swap(state->pending);
+        state->taken.wakeAll();
+    }
+
+    if (!chunk.isEmpty()) emit chunkReady(chunk);
+    if (state == m_state) emit progress(state->done, state->total);
+}
+
+QVector<int> TranslationTask::cut(const QString &text, int from, int to) {
+    QVector<int> lengths;
+    const char16_t *data = reinterpret_cast<const char16_t *>(text.constData());
+    chieru::cut_pieces(data + from, data + to, kPieceLength, [&lengths](std::size_t length) {
+        lengths.push_back(static_cast<int>(length));
+    });
+    return lengths;
+}
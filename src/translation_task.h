@@ -0,0 +1,130 @@
+/**
+ * @file translation_task.h
+ * @author H1MSK (ksda47832338@outlook.com)
+ * @brief Background translation of whole texts
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class ChieruTranslator;
+class QTextCodec;
+class QTimer;
+template <typename T> class QFutureWatcher;
+
+/**
+ * @brief What a TranslationTask produced
+ */
+struct TranslationResult
+{
+    // Empty when the text was streamed through chunkReady()
+    QString text;
+
+    // Translating into Chieru only: lengths of the pieces the text was cut
+    // into, and of their translations without the header
+    QVector<int> original_lengths;
+    QVector<int> translated_lengths;
+};
+
+/**
+ * @brief Translates a whole text on the global thread pool, piece by piece, so
+ *          that it can be cancelled between pieces
+ *
+ * Streamed tasks hand the translation out in chunks while they run instead of
+ * in the result, so that large documents show up bit by bit without another
+ * full copy of the text being held. The pool thread waits while chunks pile
+ * up faster than they are taken.
+ */
+class TranslationTask : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Direction {
+        ToChieru,
+        FromChieru
+    };
+
+    // Texts are cut at the first separator after every this many charactors
+    static const int kPieceLength = 4096;
+
+    // Chunks and progress are handed out every this many milliseconds
+    static const int kStreamInterval = 50;
+
+    explicit TranslationTask(ChieruTranslator *translator, QObject *parent = nullptr);
+    ~TranslationTask();
+
+    /**
+     * @brief Start translating the text, cancelling what is still running
+     */
+    void start(Direction direction, const QString &text, QTextCodec *codec);
+
+    /**
+     * @brief Whether tasks started from now on stream their translation
+     */
+    void setStreaming(bool streaming) { m_streaming = streaming; }
+    bool isStreaming() const { return m_streaming; }
+
+    /**
+     * @brief Stop the running translation, finished() won't be emitted for it
+     */
+    void cancel();
+
+    bool isRunning() const { return m_watcher != nullptr; }
+
+    /**
+     * @brief Lengths of the pieces text is cut into, each but the last ending
+     *          right after a separator
+     */
+    static QVector<int> cut(const QString &text, int from, int to);
+
+    struct State;
+
+signals:
+    /**
+     * @brief Count of charactors of the text translated so far
+     */
+    void progress(int done, int total);
+
+    /**
+     * @brief Next part of the translation, streamed tasks only
+     */
+    void chunkReady(const QString &chunk);
+
+    void finished(const TranslationResult &result);
+
+private:
+    // Hand out what the running task produced since last time
+    void drain();
+
+    ChieruTranslator *m_translator;
+    QFutureWatcher<TranslationResult> *m_watcher;
+    QSharedPointer<State> m_state;
+    QTimer *m_stream_timer;
+    bool m_streaming;
+};
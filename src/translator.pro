@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -16,17 +16,31 @@ DEFINES += QT_DEPRECATED_WARNINGS QT
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    background.cpp \
+    chieru_async.cpp \
     chieru_translator.cpp \
-    gui.cpp
+    chieru_word_cache.cpp \
+    codec_layout.cpp \
+    gui.cpp \
+    live_translation.cpp \
+    translation_task.cpp
 
 HEADERS += \
+    background.h \
+    chieru_async.h \
     chieru_translator.h \
+    chieru_word_cache.h \
+    codec_layout.h \
     gui.h \
-    singleton.h
+    live_translation.h \
+    singleton.h \
+    translation_task.h
 
 FORMS += \
     gui.ui
 
+include(chieru_core.pri)
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -38,6 +52,14 @@ DISTFILES += \
 RESOURCES += \
     resource.qrc
 
+# Backgrounds are picked by index, so count them here instead of probing the
+# resources at startup. Each of them must be listed in resource.qrc as well.
+HORIZONTAL_BACKGROUNDS = $$files($$PWD/imgs/chieruh*.png)
+VERTICAL_BACKGROUNDS = $$files($$PWD/imgs/chieruv*.png)
+DEFINES += \
+    CHIERU_HORIZONTAL_BACKGROUNDS=$$size(HORIZONTAL_BACKGROUNDS) \
+    CHIERU_VERTICAL_BACKGROUNDS=$$size(VERTICAL_BACKGROUNDS)
+
 RC_ICONS = imgs/chierui0.ico
 
 ANDROID {